@@ -0,0 +1,109 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "alloc_tracker.h"
+#include "scripted_world.h"
+
+namespace {
+    const std::string USAGE = "usage: slinger-alloccheck [--elements count] [--warmup frames] [--frames frames]";
+
+    struct Totals {
+        std::uint64_t frames = 0;
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+    };
+}
+
+/**
+ * Plays a generated level headlessly with scripted input and fails if any frame allocates once
+ * it has warmed up, listing what each system allocated
+ */
+int main(int argc, char *argv[]) {
+    spdlog::set_pattern("[%l] %v");
+
+    if (!AllocTracker::isAvailable()) {
+        SPDLOG_ERROR("Allocations aren't tracked in this build, configure with SLINGER_ALLOC_TRACKING");
+        return 2;
+    }
+
+    std::size_t elements = 1000;
+    int warmup = 240;
+    int frames = 1200;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--elements" && hasValue) {
+                elements = std::stoul(argv[++i]);
+            } else if (arg == "--warmup" && hasValue) {
+                warmup = std::stoi(argv[++i]);
+            } else if (arg == "--frames" && hasValue) {
+                frames = std::stoi(argv[++i]);
+            } else {
+                std::cerr << USAGE << std::endl;
+                return 2;
+            }
+        }
+    } catch (const std::logic_error& error) {
+        SPDLOG_ERROR("Invalid argument: {}", error.what());
+        std::cerr << USAGE << std::endl;
+        return 2;
+    }
+
+    ScriptedWorld world(elements);
+
+    // Let containers grow to their working size before anything counts
+    for (int tick = 0; tick < warmup; tick++) {
+        world.step(tick);
+    }
+    AllocTracker::endFrame();
+
+    std::map<std::string, Totals> systems;
+    std::uint64_t allocatingFrames = 0;
+
+    for (int tick = warmup; tick < warmup + frames; tick++) {
+        world.step(tick);
+
+        auto report = AllocTracker::endFrame();
+        AllocPause pause;
+
+        if (report.allocations > 0) {
+            allocatingFrames++;
+        }
+
+        for (const auto &system : report.systems) {
+            if (system.allocations > 0) {
+                auto &totals = systems[system.name];
+                totals.frames++;
+                totals.allocations += system.allocations;
+                totals.bytes += system.bytes;
+            }
+        }
+    }
+
+    for (const auto &[name, totals] : systems) {
+        SPDLOG_WARN(
+            "{} allocated in {} of {} frames, {:.1f} times and {:.0f} bytes a frame on average",
+            name,
+            totals.frames,
+            frames,
+            (double) totals.allocations / frames,
+            (double) totals.bytes / frames
+        );
+    }
+
+    if (allocatingFrames > 0) {
+        SPDLOG_ERROR("{} of {} frames allocated", allocatingFrames, frames);
+        return 1;
+    }
+
+    SPDLOG_INFO("No allocations in {} frames", frames);
+    return 0;
+}
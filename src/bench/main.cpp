@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "level_reader.h"
+#include "map_maker.h"
+
+namespace {
+    const std::string LEVEL_PATH = "data/levels";
+
+    // Levels are copied here so loading them cooks the copies, not the levels in the source tree
+    const auto COOK_PATH = std::filesystem::temp_directory_path() / "slingerbench-levels";
+
+    void readLevel(benchmark::State& state, const std::string& path) {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(LevelReader::readFile(path));
+        }
+    }
+
+    // Goes through the cooked copy like the game does, which is written next to the copied svg
+    // on the first run
+    void makeLevel(benchmark::State& state, const std::string& path) {
+        for (auto _ : state) {
+            state.PauseTiming();
+            {
+                entt::registry registry;
+                entt::dispatcher dispatcher;
+                Physics physics(registry, dispatcher);
+                MapMaker mapMaker(registry, physics);
+                state.ResumeTiming();
+
+                mapMaker.make(path);
+
+                // Tearing the world down isn't part of loading
+                state.PauseTiming();
+            }
+            state.ResumeTiming();
+        }
+    }
+}
+
+/**
+ * Runs every benchmark, adding ones for loading each level in data/levels. Pass
+ * --benchmark_out=results.json --benchmark_out_format=json to keep results for comparing builds.
+ */
+int main(int argc, char** argv) {
+    spdlog::set_level(spdlog::level::warn);
+
+    if (std::filesystem::exists(LEVEL_PATH)) {
+        std::filesystem::remove_all(COOK_PATH);
+        std::filesystem::create_directories(COOK_PATH);
+
+        for (const auto &entry : std::filesystem::directory_iterator(LEVEL_PATH)) {
+            if (entry.path().extension() != ".svg") {
+                continue;
+            }
+
+            auto copy = COOK_PATH / entry.path().filename();
+            std::filesystem::copy_file(entry.path(), copy);
+
+            auto path = copy.generic_string();
+            auto name = entry.path().stem().string();
+
+            benchmark::RegisterBenchmark(("BM_LevelReaderRead/" + name).c_str(), readLevel, path)
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("BM_MapMakerMake/" + name).c_str(), makeLevel, path)
+                ->Unit(benchmark::kMillisecond);
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    std::filesystem::remove_all(COOK_PATH);
+
+    return 0;
+}
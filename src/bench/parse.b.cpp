@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "path_builder.h"
+#include "regexer.h"
+
+namespace {
+    const std::string SHORT_PATH = "M 72.732231,91.993675 H 85.979527 L 72.732231,118.39366 Z";
+
+    // A long wavy outline of cubic curves, about the size of a detailed piece of scenery art
+    std::string makeHugePath(int segments) {
+        std::string path = "M 0,0";
+
+        for (int i = 0; i < segments; i++) {
+            auto x = std::to_string(i * 4);
+            path += " C " + x + ",2 " + std::to_string(i * 4 + 2) + ",-2 " + std::to_string(i * 4 + 4) + ",0";
+        }
+
+        return path + " V 20 H 0 Z";
+    }
+}
+
+static void BM_PathBuilderShort(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PathBuilder::build(SHORT_PATH));
+    }
+}
+BENCHMARK(BM_PathBuilderShort);
+
+static void BM_PathBuilderHuge(benchmark::State& state) {
+    auto path = makeHugePath((int) state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PathBuilder::build(path));
+    }
+
+    state.SetBytesProcessed((std::int64_t) state.iterations() * (std::int64_t) path.size());
+}
+BENCHMARK(BM_PathBuilderHuge)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_RegexerSearch(benchmark::State& state) {
+    Regexer regexer(R"(\s?([a-zA-Z])\s([^a-zA-Z]+\s))");
+    auto path = makeHugePath((int) state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(regexer.search(path));
+    }
+}
+BENCHMARK(BM_RegexerSearch)->Arg(10)->Arg(1000);
+
+static void BM_RegexerMatches(benchmark::State& state) {
+    Regexer regexer(R"(\s?([a-zA-Z])\s([^a-zA-Z]+\s))");
+    auto path = makeHugePath((int) state.range(0));
+
+    for (auto _ : state) {
+        std::size_t count = 0;
+        for (const auto &match : regexer.matches(path)) {
+            benchmark::DoNotOptimize(match.group(0));
+            count++;
+        }
+
+        benchmark::DoNotOptimize(count);
+    }
+}
+BENCHMARK(BM_RegexerMatches)->Arg(10)->Arg(1000);
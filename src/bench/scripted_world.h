@@ -0,0 +1,68 @@
+#ifndef SLINGER_SCRIPTED_WORLD_H
+#define SLINGER_SCRIPTED_WORLD_H
+
+#include <cmath>
+
+#include "level_generator.h"
+#include "level_reader.h"
+#include "map_maker.h"
+#include "physics.h"
+#include "tracer.h"
+
+/**
+ * A generated level in a world of its own with a scripted player, the same level and the same
+ * input every run
+ */
+struct ScriptedWorld {
+    entt::registry registry;
+    entt::dispatcher dispatcher;
+    Physics physics;
+    MapMaker mapMaker;
+
+    explicit ScriptedWorld(std::size_t elements):
+        physics(registry, dispatcher),
+        mapMaker(registry, physics)
+    {
+        auto svg = LevelGenerator().setElements(elements).setSeed(1).generate();
+        mapMaker.build(LevelReader::readBuffer(svg.data(), svg.size(), "bench"));
+    }
+
+    /**
+     * Walk right, jump every half second and fire the rope every second, the way a player might
+     */
+    void script(int tick) {
+        SLINGER_TRACE("ScriptedWorld::script");
+
+        registry.view<Movement>().each([tick](const auto entity, Movement &movement) {
+            movement.direction = (tick / 120) % 2 == 0 ? 1.f : -1.f;
+        });
+
+        if (tick % 30 == 0) {
+            registry.view<Movement>().each([this](const auto entity, Movement &movement) {
+                enqueueEvent(registry, dispatcher, Event(entity, Jump { 8 }));
+            });
+        }
+
+        if (tick % 60 == 0) {
+            registry.view<entt::tag<"rotate_to_mouse"_hs>>().each([this](const auto entity) {
+                enqueueEvent(registry, dispatcher, Event(entity, FireRope { sf::Vector2f(0, 0.5f), sf::Vector2f(0, 0.7f) }));
+            });
+        }
+    }
+
+    [[nodiscard]] sf::Vector2f mouse(int tick) const {
+        float angle = (float) tick * 0.05f;
+        return sf::Vector2f(std::cos(angle), std::sin(angle)) * 10.f;
+    }
+
+    /**
+     * Everything a frame of the game does apart from input and drawing
+     */
+    void step(int tick) {
+        script(tick);
+        physics.handlePhysics(registry, 1.f / 60.f, mouse(tick));
+        mapMaker.update();
+    }
+};
+
+#endif //SLINGER_SCRIPTED_WORLD_H
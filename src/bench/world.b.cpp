@@ -0,0 +1,64 @@
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include "illustrator.h"
+#include "scripted_world.h"
+
+static void BM_PhysicsStep(benchmark::State& state) {
+    const auto ticks = (int) state.range(1);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        {
+            ScriptedWorld world((std::size_t) state.range(0));
+            state.ResumeTiming();
+
+            for (int tick = 0; tick < ticks; tick++) {
+                world.script(tick);
+                world.physics.handlePhysics(world.registry, 1.f / 60.f, world.mouse(tick));
+            }
+
+            // Tearing the world down isn't part of stepping it
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed((std::int64_t) state.iterations() * ticks);
+}
+BENCHMARK(BM_PhysicsStep)->Args({ 1000, 600 })->Args({ 10000, 600 })->Unit(benchmark::kMillisecond);
+
+static void BM_IllustratorDraw(benchmark::State& state) {
+    sf::RenderTexture target;
+    if (!target.create(1280, 720)) {
+        state.SkipWithError("Could not create a render texture, there is no OpenGL context");
+        return;
+    }
+
+    ScriptedWorld world((std::size_t) state.range(0));
+
+    // With no workers the vertices are built on this thread alone
+    std::unique_ptr<ThreadPool> pool;
+    if (state.range(1) > 0) {
+        pool = std::make_unique<ThreadPool>((std::size_t) state.range(1));
+    }
+
+    Illustrator illustrator(target, world.registry, world.dispatcher, pool.get());
+    RenderSnapshot snapshot;
+
+    // Both halves on one thread, so this is the cost of a frame before it was split
+    for (auto _ : state) {
+        illustrator.capture(snapshot);
+        illustrator.draw(snapshot);
+        target.display();
+    }
+}
+BENCHMARK(BM_IllustratorDraw)
+    ->Args({ 1000, 0 })
+    ->Args({ 10000, 0 })
+    ->Args({ 10000, 2 })
+    ->Args({ 10000, 4 })
+    ->Unit(benchmark::kMicrosecond);
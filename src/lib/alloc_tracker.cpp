@@ -0,0 +1,159 @@
+//
+// Created by derek on 25/11/20.
+//
+
+#include "alloc_tracker.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+std::atomic<bool> AllocTracker::enabled_ { AllocTracker::isAvailable() };
+
+const std::size_t AllocTracker::MAX_SYSTEMS = 128;
+const char* const AllocTracker::UNTRACKED = "untracked";
+const char* const AllocTracker::OTHER = "other";
+
+namespace {
+    struct System {
+        std::atomic<const char*> name { nullptr };
+        std::atomic<std::uint64_t> allocations { 0 };
+        std::atomic<std::uint64_t> bytes { 0 };
+    };
+
+    // Constant initialised, so allocations made before main are counted safely
+    std::array<System, AllocTracker::MAX_SYSTEMS> systems;
+
+    thread_local const char* currentSystem = nullptr;
+    thread_local int pausedDepth = 0;
+
+    System& slot(const char* name) {
+        auto start = (std::size_t) (reinterpret_cast<std::uintptr_t>(name) >> 3u) % systems.size();
+
+        // Open addressing on the name's address, slots are claimed once and never given back
+        for (std::size_t i = 0; i < systems.size(); i++) {
+            auto &system = systems[(start + i) % systems.size()];
+            auto *claimed = system.name.load(std::memory_order_acquire);
+
+            if (!claimed && system.name.compare_exchange_strong(claimed, name, std::memory_order_acq_rel)) {
+                return system;
+            }
+
+            // Another thread may have just claimed it for the same system
+            if (claimed == name) {
+                return system;
+            }
+        }
+
+        // With every slot taken by other systems there's nowhere better than where we started
+        return name == AllocTracker::OTHER ? systems[start] : slot(AllocTracker::OTHER);
+    }
+}
+
+void AllocTracker::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+const char *AllocTracker::enter(const char *system) {
+    auto *previous = currentSystem;
+    currentSystem = system;
+
+    return previous;
+}
+
+void AllocTracker::leave(const char *previous) {
+    currentSystem = previous;
+}
+
+void AllocTracker::record(std::size_t bytes) {
+    if (!isEnabled() || pausedDepth > 0) {
+        return;
+    }
+
+    auto &system = slot(currentSystem ? currentSystem : UNTRACKED);
+    system.allocations.fetch_add(1, std::memory_order_relaxed);
+    system.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+AllocTracker::FrameReport AllocTracker::endFrame() {
+    AllocPause pause;
+    FrameReport report;
+
+    for (auto &system : systems) {
+        auto *name = system.name.load(std::memory_order_acquire);
+        if (!name) {
+            continue;
+        }
+
+        report.systems.push_back(SystemAllocations {
+            name,
+            system.allocations.exchange(0, std::memory_order_relaxed),
+            system.bytes.exchange(0, std::memory_order_relaxed)
+        });
+    }
+
+    // The same zone name can be a different literal in each file, so merge them by value
+    std::sort(report.systems.begin(), report.systems.end(), [](const auto &lhs, const auto &rhs) {
+        return std::strcmp(lhs.name, rhs.name) < 0;
+    });
+
+    std::vector<SystemAllocations> merged;
+    for (const auto &system : report.systems) {
+        if (!merged.empty() && std::strcmp(merged.back().name, system.name) == 0) {
+            merged.back().allocations += system.allocations;
+            merged.back().bytes += system.bytes;
+        } else {
+            merged.push_back(system);
+        }
+
+        report.allocations += system.allocations;
+        report.bytes += system.bytes;
+    }
+
+    std::stable_sort(merged.begin(), merged.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.bytes > rhs.bytes;
+    });
+    report.systems = std::move(merged);
+
+    return report;
+}
+
+int &AllocTracker::paused() {
+    return pausedDepth;
+}
+
+#ifdef SLINGER_ALLOC_TRACKING
+// Everything else operator new and delete has, arrays and nothrow, goes through these
+void *operator new(std::size_t size) {
+    AllocTracker::record(size);
+
+    if (void *memory = std::malloc(size > 0 ? size : 1)) {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+    ::operator delete(memory);
+}
+
+// Sized deletes are replaced too so -Wsized-deallocation doesn't warn about the ones above
+void operator delete(void *memory, std::size_t) noexcept {
+    ::operator delete(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept {
+    ::operator delete(memory);
+}
+#endif
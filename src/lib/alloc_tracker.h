@@ -0,0 +1,104 @@
+//
+// Created by derek on 25/11/20.
+//
+
+#ifndef SLINGER_ALLOC_TRACKER_H
+#define SLINGER_ALLOC_TRACKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Counts heap allocations made through global operator new, attributing each one to the trace
+ * zone the allocating thread is in. Built with SLINGER_ALLOC_TRACKING operator new is replaced
+ * and every SLINGER_TRACE zone names the system its allocations belong to, without it nothing
+ * is counted.
+ *
+ * Counting never allocates or takes a lock, each system has a fixed slot of atomic counters.
+ */
+class AllocTracker {
+    static std::atomic<bool> enabled_;
+
+public:
+    struct SystemAllocations {
+        const char* name;
+        std::uint64_t allocations;
+        std::uint64_t bytes;
+    };
+
+    struct FrameReport {
+        // Every system seen so far, including those that didn't allocate this frame
+        std::vector<SystemAllocations> systems;
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    static const std::size_t MAX_SYSTEMS;
+
+    // Where allocations made outside any zone are counted
+    static const char* const UNTRACKED;
+
+    // Where allocations are counted once every slot is taken
+    static const char* const OTHER;
+
+    /**
+     * Whether operator new was replaced, the tracker is enabled from the start when it was
+     */
+    static constexpr bool isAvailable() {
+#ifdef SLINGER_ALLOC_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Attribute the calling thread's allocations to a system until leave is called
+     * @param system has to outlive the tracker, systems are named with string literals
+     * @return the system to go back to
+     */
+    static const char* enter(const char* system);
+    static void leave(const char* previous);
+
+    /**
+     * Count an allocation against the calling thread's current system
+     */
+    static void record(std::size_t bytes);
+
+    /**
+     * Take everything counted since the last frame ended and start counting the next one
+     */
+    static FrameReport endFrame();
+
+private:
+    friend class AllocPause;
+    static int& paused();
+};
+
+/**
+ * Stops the calling thread's allocations being counted while it exists, for bookkeeping that
+ * shouldn't be blamed on the frame
+ */
+class AllocPause {
+public:
+    AllocPause() {
+        AllocTracker::paused()++;
+    }
+
+    ~AllocPause() {
+        AllocTracker::paused()--;
+    }
+
+    AllocPause(const AllocPause&) = delete;
+    AllocPause& operator=(const AllocPause&) = delete;
+};
+
+
+#endif //SLINGER_ALLOC_TRACKER_H
@@ -67,6 +67,12 @@ ShapeBuilder &ShapeBuilder::setZIndex(int z) {
     return *this;
 }
 
+ShapeBuilder &ShapeBuilder::setCollisionTolerance(float tolerance) {
+    prototype_.collisionTolerance = tolerance;
+
+    return *this;
+}
+
 ShapeBuilder::ShapeBuilder(std::unique_ptr<sf::Shape> shape) {
     prototype_.shape = std::move(shape);
 }
@@ -78,7 +84,7 @@ entt::entity ShapeBuilder::create(entt::registry &registry, std::optional<entt::
 
     registry.emplace<Drawable>(
         entity.value(),
-        Drawable { std::move(prototype_.shape), prototype_.zIndex }
+        registry.ctx_or_set<MeshCache>().createDrawable(*prototype_.shape, prototype_.zIndex)
     );
 
     return entity.value();
@@ -94,12 +100,15 @@ ShapeBuilder ShapeBuilder::CreateRect(float width, float height) {
     return ShapeBuilder(std::move(rect));
 }
 
-ShapeBuilder ShapeBuilder::CreatePolygon(const std::vector<sf::Vector2f>& points) {
-    auto shape = std::make_unique<sf::ConvexShape>();
+ShapeBuilder ShapeBuilder::CreateMesh(
+    std::vector<sf::Vector2f> outline,
+    Mesh mesh,
+    std::vector<DetailMesh> detailLevels
+) {
+    auto shape = std::make_unique<MeshShape>(std::move(outline), std::move(mesh));
 
-    shape->setPointCount(points.size());
-    for (std::size_t i = 0; i != points.size(); ++i) {
-        shape->setPoint(i, points[i]);
+    for (auto &detail : detailLevels) {
+        shape->addDetailLevel(detail.tolerance, std::move(detail.mesh));
     }
 
     return ShapeBuilder(std::move(shape));
@@ -112,7 +121,7 @@ ShapeBuilder &ShapeBuilder::setOutline(float thickness, sf::Color color) {
     return *this;
 }
 
-ShapeBuilder &ShapeBuilder::setTexture(sf::Texture *texture) {
+ShapeBuilder &ShapeBuilder::setTexture(const sf::Texture *texture) {
     prototype_.shape->setTexture(texture);
     //rect->setTextureRect(sf::IntRect(0, 0, width * 60, 50));
 
@@ -122,7 +131,19 @@ ShapeBuilder &ShapeBuilder::setTexture(sf::Texture *texture) {
     return *this;
 }
 
+ShapeBuilder &ShapeBuilder::setTexture(const AtlasRegion &region) {
+    region_ = &region;
+    setTexture(region.texture);
+    prototype_.shape->setTextureRect(region.rect);
+
+    return *this;
+}
+
 ShapeBuilder &ShapeBuilder::setTextureRect(sf::IntRect bounds) {
+    if (region_) {
+        bounds = region_->map(bounds);
+    }
+
     prototype_.shape->setTextureRect(bounds);
 
     return *this;
@@ -142,8 +163,8 @@ ShapeBuilder BodyBuilder::addRect(float width, float height) {
     return builder;
 }
 
-ShapeBuilder BodyBuilder::addPolygon(const std::vector<sf::Vector2f>& points) {
-    auto builder = ShapeBuilder::CreatePolygon(points);
+ShapeBuilder BodyBuilder::addMesh(std::vector<sf::Vector2f> outline, Mesh mesh) {
+    auto builder = ShapeBuilder::CreateMesh(std::move(outline), std::move(mesh));
     builder.setBodyBuilder(this);
 
     return builder;
@@ -184,7 +205,13 @@ entt::entity BodyBuilder::create() {
         auto shapeEntity = registry_.create();
 
         if (prototype.makeFixture) {
-            auto& fix = physics_.makeFixture(shapeEntity, prototype.shape.get(), registry_, entity_);
+            auto& fix = physics_.makeFixture(
+                shapeEntity,
+                prototype.shape.get(),
+                registry_,
+                entity_,
+                prototype.collisionTolerance
+            );
             fix->value->SetSensor(prototype.sensor);
 
             if (prototype.footSensor) {
@@ -195,7 +222,7 @@ entt::entity BodyBuilder::create() {
         if (prototype.draw) {
             registry_.emplace<Drawable>(
                 shapeEntity,
-                Drawable { std::move(prototype.shape), prototype.zIndex }
+                registry_.ctx_or_set<MeshCache>().createDrawable(*prototype.shape, prototype.zIndex)
             );
         }
     }
@@ -11,6 +11,8 @@
 #include <SFML/Graphics/RectangleShape.hpp>
 #include "physics.h"
 #include "illustrator.h"
+#include "texture_atlas.h"
+#include "mesh_shape.h"
 
 class ShapeBuilder;
 
@@ -23,6 +25,7 @@ struct ShapePrototype {
     float density = 1;
     float friction = 0.2f;
     int zIndex = 0;
+    float collisionTolerance = 0;
 };
 
 struct AttachPrototype {
@@ -49,7 +52,7 @@ public:
     explicit BodyBuilder(entt::registry &registry, Physics &physics);
     BodyBuilder& addShape(ShapePrototype);
     ShapeBuilder addRect(float width, float height);
-    ShapeBuilder addPolygon(const std::vector<sf::Vector2f>& points);
+    ShapeBuilder addMesh(std::vector<sf::Vector2f> outline, Mesh mesh);
     BodyBuilder &setPos(float x, float y);
     BodyBuilder &setType(b2BodyType type);
     BodyBuilder &setRot(float rot);
@@ -62,11 +65,19 @@ class ShapeBuilder {
 private:
     BodyBuilder* bodyBuilder_;
     ShapePrototype prototype_;
+    const AtlasRegion* region_ = nullptr;
 
 public:
 
     static ShapeBuilder CreateRect(float width, float height);
-    static ShapeBuilder CreatePolygon(const std::vector<sf::Vector2f>& points);
+    /**
+     * Create a polygon that has already been triangulated
+     */
+    static ShapeBuilder CreateMesh(
+        std::vector<sf::Vector2f> outline,
+        Mesh mesh,
+        std::vector<DetailMesh> detailLevels = {}
+    );
 
     void setBodyBuilder(BodyBuilder *bodyBuilder);
     ShapeBuilder& setPos(float x, float y);
@@ -79,7 +90,18 @@ public:
     ShapeBuilder& setColor(sf::Color color);
     ShapeBuilder& setFootSensor();
     ShapeBuilder& setZIndex(int z);
-    ShapeBuilder& setTexture(sf::Texture *texture);
+
+    /**
+     * Simplify polygon fixtures so that no removed point is further than the tolerance away
+     */
+    ShapeBuilder& setCollisionTolerance(float tolerance);
+    ShapeBuilder& setTexture(const sf::Texture *texture);
+
+    /**
+     * Texture the shape with an image packed into a TextureAtlas, any texture rect set
+     * afterwards is relative to the original image rather than the atlas page.
+     */
+    ShapeBuilder& setTexture(const AtlasRegion& region);
     ShapeBuilder& setTextureRect(sf::IntRect bounds);
 
     ShapeBuilder& setOutline(float thickness, sf::Color color = sf::Color::Black);
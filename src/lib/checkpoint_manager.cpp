@@ -5,6 +5,8 @@
 #include <iostream>
 #include <spdlog/spdlog.h>
 #include "checkpoint_manager.h"
+#include "metrics.h"
+#include "tracer.h"
 
 CheckpointManager::CheckpointManager(entt::registry &registry, entt::dispatcher &dispatcher,
     entt::dispatcher& sceneDispatcher)
@@ -40,10 +42,10 @@ void CheckpointManager::onCheckpoint(const EnteredCheckpoint &event) {
     }
 
     respawnable->lastCheckpointLoc = event.eventDef.zone.respawnLoc;
-    SPDLOG_INFO("Entity {} reached new checkpoint at ({}, {})", event.entity, respawnable->lastCheckpointLoc.x, respawnable->lastCheckpointLoc.y);
+    SPDLOG_LOGGER_INFO(log_, "Entity {} reached new checkpoint at ({}, {})", event.entity, respawnable->lastCheckpointLoc.x, respawnable->lastCheckpointLoc.y);
 
     if (event.eventDef.zone.finish) {
-        SPDLOG_INFO("Entity {} has finished the level!", event.entity);
+        SPDLOG_LOGGER_INFO(log_, "Entity {} has finished the level!", event.entity);
         despawn(event.entity, *respawnable);
         respawnable->finished = true;
 
@@ -51,11 +53,13 @@ void CheckpointManager::onCheckpoint(const EnteredCheckpoint &event) {
             timeable->stop();
         }
 
-        dispatcher_.enqueue(Event<Death>(event.entity, Death {}));
+        enqueueEvent(registry_, dispatcher_, Event<Death>(event.entity, Death {}));
     }
 }
 
 void CheckpointManager::update(sf::Time delta) {
+    SLINGER_TRACE("CheckpointManager::update");
+
     registry_.view<Respawnable>().each(
         [this, delta](const auto entity, Respawnable &respawnable) {
             if (!respawnable.dead) {
@@ -83,18 +87,22 @@ void CheckpointManager::update(sf::Time delta) {
 }
 
 void CheckpointManager::respawn(entt::entity entity, Respawnable &respawnable) {
+    registry_.ctx_or_set<Metrics>().increment("respawns");
+
     respawnable.dead = false;
     registry_.emplace_or_replace<Follow>(entity);
-    dispatcher_.enqueue(Event<Teleport>(entity, Teleport(respawnable.lastCheckpointLoc)));
-    SPDLOG_INFO("Entity {} has has respawned at ({}, {})", entity, respawnable.lastCheckpointLoc.x, respawnable.lastCheckpointLoc.y);
+    enqueueEvent(registry_, dispatcher_, Event<Teleport>(entity, Teleport(respawnable.lastCheckpointLoc)));
+    SPDLOG_LOGGER_INFO(log_, "Entity {} has has respawned at ({}, {})", entity, respawnable.lastCheckpointLoc.x, respawnable.lastCheckpointLoc.y);
 }
 
 void CheckpointManager::despawn(entt::entity entity, Respawnable& respawnable) {
+    registry_.ctx_or_set<Metrics>().increment("deaths");
+
     registry_.remove_if_exists<Follow>(entity);
 
-    dispatcher_.enqueue(Event<Death>(entity, Death {}));
+    enqueueEvent(registry_, dispatcher_, Event<Death>(entity, Death {}));
 
     respawnable.dead = true;
     respawnable.currentRespawnTime = respawnable.respawnTime;
-    SPDLOG_INFO("Entity {} has died, will respawn in {} seconds", entity, respawnable.currentRespawnTime.asSeconds());
+    SPDLOG_LOGGER_INFO(log_, "Entity {} has died, will respawn in {} seconds", entity, respawnable.currentRespawnTime.asSeconds());
 }
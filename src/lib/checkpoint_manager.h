@@ -10,6 +10,7 @@
 #include <entt/entt.hpp>
 #include "events.h"
 #include "misc_components.h"
+#include "logging.h"
 
 namespace {
     using EnteredDeathZone = Event<EnteredZone<DeathZone>>;
@@ -20,6 +21,7 @@ class CheckpointManager {
     entt::registry& registry_;
     entt::dispatcher& dispatcher_;
     entt::dispatcher& sceneDispatcher_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::CHECKPOINTS);
 
     void onDeathZone(const EnteredDeathZone &event);
     void onCheckpoint(const EnteredCheckpoint &event);
@@ -5,9 +5,14 @@
 #ifndef SLINGER_EVENTS_H
 #define SLINGER_EVENTS_H
 
-#include <entt/entity/fwd.hpp>
+#include <utility>
+
+#include <entt/entity/registry.hpp>
+#include <entt/signal/dispatcher.hpp>
 #include <SFML/Audio.hpp>
 
+#include "metrics.h"
+
 template <class T>
 struct Event {
     entt::entity entity;
@@ -57,6 +62,10 @@ struct StartLevel {
     inline explicit StartLevel(std::string level): levelPath(level) {};
 };
 
+struct StartEndless {
+
+};
+
 struct FinishLevel {
     sf::Time completeTime;
 };
@@ -65,11 +74,22 @@ struct ExitLevel {};
 
 struct OpenTutorial {};
 
+struct ToggleFrameStats {};
+
 struct ResizeWindow {
     unsigned int width;
     unsigned int height;
 };
 
+/**
+ * Queue a game event for the next dispatch, counting it once however many handlers it has
+ */
+template <class T>
+void enqueueEvent(entt::registry& registry, entt::dispatcher& dispatcher, T&& event) {
+    registry.ctx_or_set<Metrics>().increment("events_dispatched");
+    dispatcher.enqueue(std::forward<T>(event));
+}
+
 inline std::string formatTime(const sf::Time& time) {
     int minutes = (int)time.asSeconds() / 60;
     float seconds = time.asSeconds() - (float) (minutes * 60);
@@ -0,0 +1,95 @@
+//
+// Created by derek on 23/11/20.
+//
+
+#include "frame_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+const std::array<const char*, (std::size_t) FrameStats::Section::COUNT> FrameStats::SECTION_NAMES = {
+    "input",
+    "physics",
+    "sync",
+    "checkpoints",
+    "draw"
+};
+
+const std::size_t FrameStats::WINDOW = 300;
+const float FrameStats::HISTOGRAM_BUCKET_MS = 2.f;
+const std::size_t FrameStats::HISTOGRAM_BUCKETS = 25;
+
+FrameStats::FrameStats():
+    samples_(WINDOW + 1)
+{
+    sorted_.reserve(WINDOW);
+}
+
+void FrameStats::addSection(Section section, float milliseconds) {
+    samples_[current_].sections[(std::size_t) section] += milliseconds;
+}
+
+void FrameStats::endFrame(float milliseconds) {
+    samples_[current_].total = milliseconds;
+
+    // One slot more than the window is kept so the frame in progress never replaces a finished one
+    current_ = (current_ + 1) % samples_.size();
+    samples_[current_] = Sample {};
+    filled_ = std::min(filled_ + 1, WINDOW);
+    frames_++;
+}
+
+void FrameStats::setCounters(const Counters &counters) {
+    counters_ = counters;
+}
+
+float FrameStats::percentile(float fraction) const {
+    if (filled_ == 0) {
+        return 0;
+    }
+
+    sorted_.clear();
+    for (std::size_t i = 1; i <= filled_; i++) {
+        sorted_.push_back(samples_[(current_ + samples_.size() - i) % samples_.size()].total);
+    }
+
+    auto rank = (std::size_t) std::ceil(std::clamp(fraction, 0.f, 1.f) * (float) filled_);
+    auto nth = sorted_.begin() + (long) (rank > 0 ? rank - 1 : 0);
+    std::nth_element(sorted_.begin(), nth, sorted_.end());
+
+    return *nth;
+}
+
+float FrameStats::averageSection(Section section) const {
+    if (filled_ == 0) {
+        return 0;
+    }
+
+    float total = 0;
+    for (std::size_t i = 1; i <= filled_; i++) {
+        total += samples_[(current_ + samples_.size() - i) % samples_.size()].sections[(std::size_t) section];
+    }
+
+    return total / (float) filled_;
+}
+
+std::vector<std::size_t> FrameStats::histogram() const {
+    std::vector<std::size_t> buckets(HISTOGRAM_BUCKETS, 0);
+
+    for (std::size_t i = 1; i <= filled_; i++) {
+        auto total = samples_[(current_ + samples_.size() - i) % samples_.size()].total;
+        auto bucket = (std::size_t) std::max(0.f, total / HISTOGRAM_BUCKET_MS);
+
+        buckets[std::min(bucket, HISTOGRAM_BUCKETS - 1)]++;
+    }
+
+    return buckets;
+}
+
+const FrameStats::Counters &FrameStats::getCounters() const {
+    return counters_;
+}
+
+std::uint64_t FrameStats::frameCount() const {
+    return frames_;
+}
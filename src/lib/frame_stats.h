@@ -0,0 +1,89 @@
+//
+// Created by derek on 23/11/20.
+//
+
+#ifndef SLINGER_FRAME_STATS_H
+#define SLINGER_FRAME_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * A rolling window of recent frame times, broken down by what the frame was spent on, along
+ * with counters describing how busy the world is
+ */
+class FrameStats {
+public:
+    enum class Section : std::size_t {
+        INPUT,
+        PHYSICS,
+        SYNC,
+        CHECKPOINTS,
+        DRAW,
+        COUNT
+    };
+
+    struct Counters {
+        std::size_t bodies = 0;
+        std::size_t contacts = 0;
+        std::size_t proxies = 0;
+        std::size_t drawables = 0;
+    };
+
+    // Lower case names of each section, for metrics
+    static const std::array<const char*, (std::size_t) Section::COUNT> SECTION_NAMES;
+
+    static const std::size_t WINDOW;
+    static const float HISTOGRAM_BUCKET_MS;
+
+    // The last bucket also holds every frame slower than the rest cover
+    static const std::size_t HISTOGRAM_BUCKETS;
+
+private:
+    struct Sample {
+        float total = 0;
+        std::array<float, (std::size_t) Section::COUNT> sections {};
+    };
+
+    std::vector<Sample> samples_;
+    std::size_t current_ = 0;
+    std::size_t filled_ = 0;
+    std::uint64_t frames_ = 0;
+    Counters counters_;
+
+    // Reused when working out percentiles so that doesn't allocate
+    mutable std::vector<float> sorted_;
+
+public:
+    FrameStats();
+
+    /**
+     * Add time spent on part of the frame in progress
+     */
+    void addSection(Section section, float milliseconds);
+
+    /**
+     * Finish the frame in progress and start a new one
+     * @param milliseconds how long the whole frame took, including anything not in a section
+     */
+    void endFrame(float milliseconds);
+
+    void setCounters(const Counters& counters);
+
+    /**
+     * The frame time that this fraction of recent frames were at least as fast as
+     */
+    [[nodiscard]] float percentile(float fraction) const;
+    [[nodiscard]] float averageSection(Section section) const;
+    [[nodiscard]] std::vector<std::size_t> histogram() const;
+    [[nodiscard]] const Counters& getCounters() const;
+
+    /**
+     * How many frames have ended since the stats were made
+     */
+    [[nodiscard]] std::uint64_t frameCount() const;
+};
+
+
+#endif //SLINGER_FRAME_STATS_H
@@ -0,0 +1,211 @@
+//
+// Created by derek on 15/11/20.
+//
+
+#include "hud.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <spdlog/spdlog.h>
+
+#include "events.h"
+
+HudText::HudText(const sf::Font &font, unsigned int characterSize, sf::Vector2f position) {
+    text_.setFont(font);
+    text_.setCharacterSize(characterSize);
+    text_.setFillColor(sf::Color::White);
+    text_.setPosition(position);
+}
+
+void HudText::setString(const std::string &string) {
+    if (string == displayed_) {
+        return;
+    }
+
+    displayed_ = string;
+    text_.setString(displayed_);
+}
+
+void HudText::setVisible(bool visible) {
+    visible_ = visible;
+}
+
+void HudText::update(const RenderSnapshot &snapshot) {
+}
+
+void HudText::draw(sf::RenderTarget &target, const sf::RenderStates &states) const {
+    if (visible_) {
+        target.draw(text_, states);
+    }
+}
+
+TimerWidget::TimerWidget(const sf::Font &font, sf::Vector2f position) :
+    HudText(font, 24, position)
+{
+}
+
+void TimerWidget::update(const RenderSnapshot &snapshot) {
+    setVisible(snapshot.showTimer);
+    if (!snapshot.showTimer) {
+        return;
+    }
+
+    long tenths = snapshot.timer.asMilliseconds() / 100;
+    if (tenths != lastTenths_) {
+        lastTenths_ = tenths;
+        setString(formatTime(snapshot.timer));
+    }
+}
+
+const std::uint64_t FrameStatsWidget::REFRESH_FRAMES = 15;
+const float FrameStatsWidget::BAR_WIDTH = 8.f;
+const float FrameStatsWidget::BAR_HEIGHT = 40.f;
+const float FrameStatsWidget::FRAME_BUDGET_MS = 1000.f / 60.f;
+
+FrameStatsWidget::FrameStatsWidget(const sf::Font &font, sf::Vector2f position) :
+    text_(font, 14, position + sf::Vector2f(6, 4)),
+    bars_(sf::Quads),
+    histogramPosition_(position + sf::Vector2f(6, 66 + BAR_HEIGHT))
+{
+    background_.setPosition(position);
+    background_.setSize(sf::Vector2f(430, 76 + BAR_HEIGHT));
+    background_.setFillColor(sf::Color(0, 0, 0, 150));
+}
+
+bool FrameStatsWidget::isVisible() const {
+    return visible_;
+}
+
+void FrameStatsWidget::update(const RenderSnapshot &snapshot) {
+    if (snapshot.showFrameStats != visible_) {
+        visible_ = snapshot.showFrameStats;
+
+        // Refresh as soon as it is shown rather than showing stale numbers
+        lastRefresh_ = 0;
+    }
+
+    if (!visible_) {
+        return;
+    }
+
+    const auto *stats = &snapshot.frameStats;
+    if (lastRefresh_ != 0 && stats->frameCount() < lastRefresh_ + REFRESH_FRAMES) {
+        return;
+    }
+
+    lastRefresh_ = std::max<std::uint64_t>(stats->frameCount(), 1);
+
+    using Section = FrameStats::Section;
+    const auto &counters = stats->getCounters();
+
+    text_.setString(fmt::format(
+        "frame   p50 {:5.1f}  p95 {:5.1f}  p99 {:5.1f} ms\n"
+        "input {:4.1f}  physics {:4.1f}  sync {:4.1f}  checkpoints {:4.1f}  draw {:4.1f}\n"
+        "bodies {}  contacts {}  proxies {}  drawables {}",
+        stats->percentile(0.5f), stats->percentile(0.95f), stats->percentile(0.99f),
+        stats->averageSection(Section::INPUT), stats->averageSection(Section::PHYSICS),
+        stats->averageSection(Section::SYNC), stats->averageSection(Section::CHECKPOINTS), stats->averageSection(Section::DRAW),
+        counters.bodies, counters.contacts, counters.proxies, counters.drawables
+    ));
+
+    // One quad per bucket scaled to the fullest, buckets slower than the frame budget are red
+    auto histogram = stats->histogram();
+    auto fullest = std::max<std::size_t>(*std::max_element(histogram.begin(), histogram.end()), 1);
+
+    bars_.clear();
+    for (std::size_t i = 0; i < histogram.size(); i++) {
+        auto height = BAR_HEIGHT * (float) histogram[i] / (float) fullest;
+        auto left = histogramPosition_.x + (float) i * (BAR_WIDTH + 1.f);
+        auto bottom = histogramPosition_.y;
+        auto slow = (float) i * FrameStats::HISTOGRAM_BUCKET_MS >= FRAME_BUDGET_MS;
+        auto colour = slow ? sf::Color(230, 80, 60) : sf::Color(120, 220, 120);
+
+        bars_.append(sf::Vertex(sf::Vector2f(left, bottom - height), colour));
+        bars_.append(sf::Vertex(sf::Vector2f(left + BAR_WIDTH, bottom - height), colour));
+        bars_.append(sf::Vertex(sf::Vector2f(left + BAR_WIDTH, bottom), colour));
+        bars_.append(sf::Vertex(sf::Vector2f(left, bottom), colour));
+    }
+}
+
+void FrameStatsWidget::draw(sf::RenderTarget &target, const sf::RenderStates &states) const {
+    if (!visible_) {
+        return;
+    }
+
+    target.draw(background_, states);
+    text_.draw(target, states);
+    target.draw(bars_, states);
+}
+
+void HudLayer::addChrome(std::unique_ptr<sf::Shape> shape) {
+    chromeItems_.push_back(std::move(shape));
+    chromeDirty_ = true;
+}
+
+void HudLayer::update(const RenderSnapshot &snapshot) {
+    for (auto &widget : widgets_) {
+        widget->update(snapshot);
+    }
+}
+
+void HudLayer::draw(sf::RenderTarget &target, const sf::View &currentView, const sf::View &hudView) {
+    if (chromeDirty_) {
+        renderChrome();
+    }
+
+    // Map hud pixels into the current view rather than switching views every frame
+    sf::RenderStates states(currentView.getInverseTransform() * hudView.getTransform());
+
+    if (!chromeItems_.empty()) {
+        target.draw(chromeSprite_, states);
+    }
+
+    for (const auto &widget : widgets_) {
+        widget->draw(target, states);
+    }
+}
+
+void HudLayer::renderChrome() {
+    chromeDirty_ = false;
+
+    if (chromeItems_.empty()) {
+        return;
+    }
+
+    auto bounds = chromeItems_.front()->getGlobalBounds();
+    for (const auto &item : chromeItems_) {
+        auto itemBounds = item->getGlobalBounds();
+        auto right = std::max(bounds.left + bounds.width, itemBounds.left + itemBounds.width);
+        auto bottom = std::max(bounds.top + bounds.height, itemBounds.top + itemBounds.height);
+
+        bounds.left = std::min(bounds.left, itemBounds.left);
+        bounds.top = std::min(bounds.top, itemBounds.top);
+        bounds.width = right - bounds.left;
+        bounds.height = bottom - bounds.top;
+    }
+
+    // Whole pixels so the cached chrome isn't resampled when it is drawn
+    auto left = std::floor(bounds.left);
+    auto top = std::floor(bounds.top);
+    auto width = (unsigned int) std::max(std::ceil(bounds.left + bounds.width - left), 1.f);
+    auto height = (unsigned int) std::max(std::ceil(bounds.top + bounds.height - top), 1.f);
+
+    if (chrome_.getSize() != sf::Vector2u(width, height) && !chrome_.create(width, height)) {
+        SPDLOG_LOGGER_ERROR(log_, "Could not create hud texture of {}x{}", width, height);
+        return;
+    }
+
+    // Drawn through a view of just the covered area, then placed back there by the sprite
+    chrome_.setView(sf::View(sf::FloatRect(left, top, (float) width, (float) height)));
+    chrome_.clear(sf::Color::Transparent);
+
+    for (const auto &item : chromeItems_) {
+        chrome_.draw(*item);
+    }
+
+    chrome_.display();
+
+    chromeSprite_.setTexture(chrome_.getTexture(), true);
+    chromeSprite_.setPosition(left, top);
+}
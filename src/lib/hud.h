@@ -0,0 +1,136 @@
+//
+// Created by derek on 15/11/20.
+//
+
+#ifndef SLINGER_HUD_H
+#define SLINGER_HUD_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "logging.h"
+#include "render_snapshot.h"
+
+/**
+ * Something drawn on the hud, in window pixel coordinates
+ */
+class HudWidget {
+public:
+    virtual ~HudWidget() = default;
+
+    /**
+     * Refresh the widget from the captured game state, called once a frame before drawing
+     */
+    virtual void update(const RenderSnapshot& snapshot) = 0;
+    virtual void draw(sf::RenderTarget& target, const sf::RenderStates& states) const = 0;
+};
+
+/**
+ * A piece of text that only rebuilds its glyphs when the string actually changes
+ */
+class HudText : public HudWidget {
+    sf::Text text_;
+    std::string displayed_;
+
+protected:
+    bool visible_ = true;
+
+public:
+    HudText(const sf::Font& font, unsigned int characterSize, sf::Vector2f position);
+
+    void setString(const std::string& string);
+    void setVisible(bool visible);
+
+    void update(const RenderSnapshot& snapshot) override;
+    void draw(sf::RenderTarget& target, const sf::RenderStates& states) const override;
+};
+
+/**
+ * Shows the level timer of the followed entity
+ */
+class TimerWidget : public HudText {
+    // The time shown is in tenths of a second so only reformat it when that changes
+    long lastTenths_ = -1;
+
+public:
+    TimerWidget(const sf::Font& font, sf::Vector2f position);
+    void update(const RenderSnapshot& snapshot) override;
+};
+
+/**
+ * Frame time percentiles, a histogram of recent frames and world counters, read from the
+ * FrameStats copied into the snapshot. It is only rebuilt a few times a second and does
+ * nothing while hidden, so it can be left on while playing.
+ */
+class FrameStatsWidget : public HudWidget {
+    static const std::uint64_t REFRESH_FRAMES;
+    static const float BAR_WIDTH;
+    static const float BAR_HEIGHT;
+    static const float FRAME_BUDGET_MS;
+
+    HudText text_;
+    sf::RectangleShape background_;
+    sf::VertexArray bars_;
+    sf::Vector2f histogramPosition_;
+    std::uint64_t lastRefresh_ = 0;
+    bool visible_ = false;
+
+public:
+    FrameStatsWidget(const sf::Font& font, sf::Vector2f position);
+
+    [[nodiscard]] bool isVisible() const;
+
+    void update(const RenderSnapshot& snapshot) override;
+    void draw(sf::RenderTarget& target, const sf::RenderStates& states) const override;
+};
+
+/**
+ * A retained layer drawn over the game. Static chrome is rendered once into a texture just big
+ * enough to cover it and widgets are kept between frames, so a frame only pays for what has
+ * changed.
+ */
+class HudLayer {
+    sf::RenderTexture chrome_;
+    sf::Sprite chromeSprite_;
+    std::vector<std::unique_ptr<sf::Shape>> chromeItems_;
+    bool chromeDirty_ = true;
+
+    std::vector<std::unique_ptr<HudWidget>> widgets_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::RENDER);
+
+public:
+    /**
+     * Add something that never changes, like a panel behind a widget
+     */
+    void addChrome(std::unique_ptr<sf::Shape> shape);
+
+    template <class T, class... Args>
+    T& addWidget(Args&&... args) {
+        auto widget = std::make_unique<T>(std::forward<Args>(args)...);
+        auto& ref = *widget;
+        widgets_.push_back(std::move(widget));
+
+        return ref;
+    }
+
+    void update(const RenderSnapshot& snapshot);
+
+    /**
+     * Draw the hud without changing the view of the target, the pixel coordinates of the hud
+     * are mapped through the given view instead
+     * @param target where to draw the hud
+     * @param currentView the view the target is currently using
+     * @param hudView a view covering the window in pixels
+     */
+    void draw(sf::RenderTarget& target, const sf::View& currentView, const sf::View& hudView);
+
+private:
+    void renderChrome();
+};
+
+
+#endif //SLINGER_HUD_H
@@ -4,93 +4,191 @@
 
 #include "illustrator.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <stdio.h>
 
 #include <entt/entity/helper.hpp>
 #include <spdlog/spdlog.h>
 
-Illustrator::Illustrator(sf::RenderWindow &window, entt::registry &registry, entt::dispatcher &dispatcher) :
-    window_(window),
-    registry_(registry),
+#include "tracer.h"
+
+const float Illustrator::MAX_DETAIL_ERROR = 0.75f;
+const float Illustrator::MIN_DETAILED_SIZE = 4.f;
+
+Illustrator::Illustrator(
+    sf::RenderTarget &target,
+    entt::registry &registry,
+    entt::dispatcher &dispatcher,
+    ThreadPool *pool
+) :
+    camera_(sf::Vector2f(0.f, 0.f), sf::Vector2f(80.f, -60.f) / 2.f),
     dispatcher_(dispatcher),
-    camera_(sf::Vector2f(0.f, 0.f), sf::Vector2f(80.f, -60.f) / 2.f)
+    registry_(registry),
+    meshes_(registry.ctx_or_set<MeshCache>()),
+    target_(target),
+    pool_(pool)
 {
-    window_.setFramerateLimit(60);
-
     dispatcher_.sink<Event<FireRope>>().connect<&Illustrator::addRope>(*this);
     dispatcher_.sink<Event<Death>>().connect<&Illustrator::onPlayerDeath>(*this);
     dispatcher.sink<ResizeWindow>().connect<&Illustrator::resizeWindow>(*this);
+    dispatcher.sink<ToggleFrameStats>().connect<&Illustrator::toggleFrameStats>(*this);
 
     registry_.on_construct<Drawable>().connect<&Illustrator::onAddDrawable>(this);
-    registry_.on_destroy<Drawable>().connect<&Illustrator::onAddDrawable>(this);
+    registry_.on_destroy<Drawable>().connect<&Illustrator::onRemoveDrawable>(this);
 
     if (!font_.loadFromFile("data/LiberationMono-Regular.ttf"))
     {
         throw std::runtime_error("Could not locate font");
     }
 
-    text_.setFont(font_);
-    text_.setCharacterSize(24);
-    text_.setFillColor(sf::Color::White);
+    // A dark backing behind the timer so it can be read over the walls
+    auto timerPanel = std::make_unique<sf::RectangleShape>(sf::Vector2f(120, 40));
+    timerPanel->setPosition(4, 6);
+    timerPanel->setFillColor(sf::Color(0, 0, 0, 90));
+    hud_.addChrome(std::move(timerPanel));
+
+    hud_.addWidget<TimerWidget>(font_, sf::Vector2f(10, 10));
+    hud_.addWidget<FrameStatsWidget>(font_, sf::Vector2f(4, 52));
 
-    resizeWindow(ResizeWindow {window_.getSize().x, window_.getSize().y});
+    resizeWindow(ResizeWindow {target_.getSize().x, target_.getSize().y});
+    resizeHud(windowSize_);
 }
 
 void Illustrator::onAddDrawable(entt::registry& registry, entt::entity entity) {
-    // Sort drawable entities by z index
-    registry_.sort<Drawable>(
-        [](const auto &lhs, const auto &rhs) {
-            return lhs.zIndex < rhs.zIndex;
-        }
-    );
+    unsorted_ = true;
+}
+
+void Illustrator::onRemoveDrawable(entt::registry& registry, entt::entity entity) {
+    // The mesh is freed once the frames that could have drawn it have been drawn
+    meshes_.release(registry.get<Drawable>(entity).mesh);
+    unsorted_ = true;
 }
 
 
 
-void Illustrator::draw(entt::registry &registry) {
-    window_.clear(sf::Color(100, 100, 100));
-    window_.setFramerateLimit(60);
+void Illustrator::capture(RenderSnapshot &snapshot) {
+    SLINGER_TRACE("Illustrator::capture");
 
-    registry.view<Follow, Position>().each(
+    registry_.view<Follow, Position>().each(
         [this](const auto entity, const Follow& follow, const Position& position) {
             this->camera_.setCenter(position.value);
         }
     );
 
-    window_.setView(camera_);
+    // Meshes released before the frame being drawn can't be in it or any frame after it
+    meshes_.collect(drawing_.load(std::memory_order_acquire));
+    snapshot.frame = meshes_.nextFrame();
+
+    // Sort drawable entities by z index
+    if (unsorted_) {
+        SLINGER_TRACE("Illustrator::sort");
+        registry_.sort<Drawable>(
+            [](const auto &lhs, const auto &rhs) {
+                return lhs.zIndex < rhs.zIndex;
+            }
+        );
+
+        unsorted_ = false;
+    }
+
+    snapshot.camera = camera_;
+    snapshot.windowSize = windowSize_;
+
+    const auto viewSize = absolute(camera_.getSize());
+    const sf::FloatRect viewBounds(camera_.getCenter() - viewSize / 2.f, viewSize);
 
-    registry.view<Drawable>().each(
-        [this, &registry](const auto entity, const Drawable &drawable) {
-            auto &pos = drawable.value->getPosition();
+    // Only what is on screen is copied, keeping the z order of the registry
+    snapshot.drawables.clear();
+    registry_.view<Drawable>().each(
+        [this, &snapshot, &viewBounds](const auto entity, Drawable &drawable) {
+            auto &pos = drawable.position;
 
-            if (registry.has<entt::tag<"wrapView"_hs>>(entity)
+            if (registry_.has<entt::tag<"wrapView"_hs>>(entity)
                 && absolute(camera_.getCenter() - pos) > absolute(camera_.getSize() / 2.f)) {
-                drawable.value->setPosition(pos + 2.f * (camera_.getCenter() - pos));
+                pos = pos + 2.f * (camera_.getCenter() - pos);
             }
 
-            window_.draw(*drawable.value);
+            if (drawable.getTransform().transformRect(meshes_.get(drawable.mesh).bounds).intersects(viewBounds)) {
+                snapshot.drawables.push_back(drawable);
+            }
         }
     );
 
-    window_.setView(uiView_);
-    registry.view<Follow, Timeable>().each(
-        [this](const auto entity, const Follow& follow, Timeable& timeable) {
-            text_.setString(timeable.formatTime());
-            text_.setPosition(10, 10);
-            //text_.setScale(1.f, 1.f);
-            window_.draw(text_);
+    snapshot.showTimer = false;
+    registry_.view<Follow, Timeable>().each(
+        [&snapshot](const auto entity, const Follow& follow, Timeable& timeable) {
+            snapshot.showTimer = true;
+            snapshot.timer = timeable.hasStarted() ? timeable.getElapsedTime() : sf::Time::Zero;
         }
     );
 
-    window_.display();
-    window_.setView(camera_);
+    snapshot.showFrameStats = showFrameStats_;
+    if (const auto *stats = registry_.try_ctx<FrameStats>(); stats && showFrameStats_) {
+        snapshot.frameStats = *stats;
+    }
+}
+
+void Illustrator::draw(const RenderSnapshot &snapshot) {
+    SLINGER_TRACE("Illustrator::draw");
+
+    // Snapshots are only ever swapped for newer ones, so every older frame is finished with
+    drawing_.store(snapshot.frame, std::memory_order_release);
+
+    if (snapshot.windowSize != hudSize_) {
+        resizeHud(snapshot.windowSize);
+    }
+
+    target_.clear(sf::Color(100, 100, 100));
+    target_.setView(snapshot.camera);
+
+    const float pixelsPerUnit = (float) snapshot.windowSize.x / std::abs(snapshot.camera.getSize().x);
+
+    // Drawables are sorted by z index, so they can be batched until the texture changes
+    commands_.clear();
+    for (const auto &drawable : snapshot.drawables) {
+        commands_.add(drawable, selectDetail(drawable, pixelsPerUnit));
+    }
+
+    commands_.build(pool_);
+    commands_.submit(target_);
+
+    SLINGER_TRACE("HudLayer::draw");
+    hud_.update(snapshot);
+    hud_.draw(target_, snapshot.camera, uiView_);
+}
+
+const sf::View &Illustrator::getCamera() const {
+    return camera_;
 }
 
 sf::Vector2f Illustrator::absolute(const sf::Vector2f &vec) {
     return sf::Vector2f(abs(vec.x), abs(vec.y));
 }
 
+const RenderMesh &Illustrator::selectDetail(const Drawable &drawable, float pixelsPerUnit) {
+    const auto &mesh = meshes_.get(drawable.mesh);
+    if (mesh.detailLevels.empty()) {
+        return mesh;
+    }
+
+    const float scale = std::max(std::abs(drawable.scale.x), std::abs(drawable.scale.y)) * pixelsPerUnit;
+    const float projectedSize = std::max(mesh.bounds.width, mesh.bounds.height) * scale;
+
+    // Use the most simplified level whose error is still too small to see
+    MeshHandle handle = drawable.mesh;
+    for (const auto &level : mesh.detailLevels) {
+        if (level.tolerance * scale > MAX_DETAIL_ERROR && projectedSize > MIN_DETAILED_SIZE) {
+            break;
+        }
+
+        handle = level.mesh;
+    }
+
+    return meshes_.get(handle);
+}
+
 void Illustrator::addRope(const Event<FireRope> &event) {
 }
 
@@ -99,7 +197,7 @@ void Illustrator::onPlayerDeath(const Event<Death> &event) {
 }
 
 void Illustrator::resizeWindow(ResizeWindow event) {
-    SPDLOG_INFO("Resizing game window to width={}, height={}", event.width, event.height);
+    SPDLOG_LOGGER_INFO(log_, "Resizing game window to width={}, height={}", event.width, event.height);
 
     float fixedWidth = 60;
     float aspectRatio = (float)event.width / (float)event.height;
@@ -107,12 +205,21 @@ void Illustrator::resizeWindow(ResizeWindow event) {
 
     camera_.setSize(fixedWidth, -height);
 
+    // The hud belongs to whoever draws, it catches up when it sees the new size in a snapshot
+    windowSize_ = sf::Vector2u(event.width, event.height);
+}
+
+void Illustrator::resizeHud(sf::Vector2u size) {
     // update the ui view to the new size of the window
-    uiView_.setSize(event.width, event.height);
-    uiView_.setCenter(event.width /2, event.height/2);
-    //uiView_.setViewport(sf::FloatRect(0, 0, event.width, event.height));
+    uiView_.setSize(size.x, size.y);
+    uiView_.setCenter(size.x / 2, size.y / 2);
+    hudSize_ = size;
 }
 
 bool operator>(const sf::Vector2f &lhs, const sf::Vector2f &rhs) {
     return lhs.x > rhs.x || lhs.y > rhs.y;
-}
\ No newline at end of file
+}
+
+void Illustrator::toggleFrameStats(const ToggleFrameStats &event) {
+    showFrameStats_ = !showFrameStats_;
+}
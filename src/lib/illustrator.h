@@ -5,37 +5,99 @@
 #ifndef SLINGER_ILLUSTRATOR_H
 #define SLINGER_ILLUSTRATOR_H
 
+#include <atomic>
+#include <cstdint>
+
 #include <SFML/Graphics.hpp>
 #include <entt/entity/registry.hpp>
 #include <entt/signal/dispatcher.hpp>
 #include "misc_components.h"
 #include "events.h"
+#include "mesh_cache.h"
+#include "hud.h"
+#include "logging.h"
+#include "render_commands.h"
+#include "render_snapshot.h"
+#include "thread_pool.h"
 
-struct Drawable {
-    std::unique_ptr<sf::Shape> value;
-    int zIndex = 0;
-};
-
+/**
+ * Draws the world in two halves. Capture copies what the camera can see out of the registry on
+ * the thread running the game, then draw turns that snapshot into vertices on whichever thread
+ * owns the render target, so the two can run at the same time on different ticks.
+ */
 class Illustrator
 {
+    // How far in pixels a simplified mesh may stray from the full mesh on screen
+    static const float MAX_DETAIL_ERROR;
+
+    // Meshes smaller than this many pixels always use their simplest detail level
+    static const float MIN_DETAILED_SIZE;
+
+    // Owned by the thread capturing
     sf::View camera_;
-    sf::View uiView_;
-    sf::RenderWindow& window_;
+    sf::Vector2u windowSize_;
+    bool showFrameStats_ = false;
+
+    // Pages and chunks add and remove many drawables at once, so they are sorted once before
+    // the next capture rather than every time one changes
+    bool unsorted_ = true;
     entt::dispatcher& dispatcher_;
     entt::registry& registry_;
+    MeshCache& meshes_;
+
+    // The frame the thread drawing is on, it is done with every frame before it
+    std::atomic<std::uint64_t> drawing_ {0};
+
+    // Owned by the thread drawing
+    sf::View uiView_;
+    sf::Vector2u hudSize_;
+    sf::RenderTarget& target_;
     sf::Font font_;
-    sf::Text text_;
+    HudLayer hud_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::RENDER);
+
+    // Vertices are built across the pool, when there is one, then drawn here in z order
+    ThreadPool* pool_;
+    RenderCommandBuffer commands_;
 
 public:
-    explicit Illustrator(sf::RenderWindow &window, entt::registry &registry, entt::dispatcher &dispatcher);
-    void draw(entt::registry &registry);
+    /**
+     * @param target a window or an offscreen texture, whoever owns it presents what is drawn
+     * @param pool workers to help build vertices, shared with whatever else uses them
+     */
+    explicit Illustrator(
+        sf::RenderTarget &target,
+        entt::registry &registry,
+        entt::dispatcher &dispatcher,
+        ThreadPool* pool = nullptr
+    );
+
+    /**
+     * Move the camera and copy everything it can see into the snapshot, reusing its memory
+     */
+    void capture(RenderSnapshot& snapshot);
+
+    /**
+     * Draw a captured tick. Only the snapshot, the target and meshes it refers to are read, so
+     * this can run while the registry is being updated.
+     */
+    void draw(const RenderSnapshot& snapshot);
+
+    /**
+     * The camera as of the last capture, for mapping the mouse into the world
+     */
+    [[nodiscard]] const sf::View& getCamera() const;
 
 private:
     sf::Vector2f absolute(const sf::Vector2f& vec);
+    const RenderMesh& selectDetail(const Drawable& drawable, float pixelsPerUnit);
+    void resizeHud(sf::Vector2u size);
     void addRope(const Event<FireRope>& event);
     void onPlayerDeath(const Event<Death>& event);
     void onAddDrawable(entt::registry &registry, entt::entity entity);
+    void onRemoveDrawable(entt::registry &registry, entt::entity entity);
     void resizeWindow(ResizeWindow event);
+    void toggleFrameStats(const ToggleFrameStats& event);
 };
 
 inline bool operator> (const sf::Vector2f& lhs, const sf::Vector2f& rhs);
@@ -2,9 +2,17 @@
 // Created by derek on 20/09/20.
 //
 
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+
 #include <iostream>
+#include <spdlog/spdlog.h>
 #include "input_manager.h"
 #include "misc_components.h"
+#include "tracer.h"
+
+const sf::Keyboard::Key InputManager::TRACE_KEY = sf::Keyboard::F9;
+const sf::Keyboard::Key InputManager::FRAME_STATS_KEY = sf::Keyboard::F3;
+const std::string InputManager::TRACE_PATH = "slinger_trace.json";
 
 InputManager::InputManager(
     sf::RenderWindow &window,
@@ -20,7 +28,9 @@ InputManager::InputManager(
 
 }
 
-UIAction InputManager::handleInput() {
+UIAction InputManager::handleInput(const sf::View& camera) {
+    SLINGER_TRACE("InputManager::handleInput");
+
     // Remove all key releases from the previous frame
     firstTimeKeyPresses_.clear();
     firstTimeButtonPresses_.clear();
@@ -37,6 +47,14 @@ UIAction InputManager::handleInput() {
             sceneDispatcher_.enqueue(ExitLevel());
         }
 
+        if (event.type == sf::Event::KeyReleased && event.key.code == FRAME_STATS_KEY) {
+            enqueueEvent(registry_, dispatcher_, ToggleFrameStats());
+        }
+
+        if (event.type == sf::Event::KeyReleased && event.key.code == TRACE_KEY) {
+            toggleTracing();
+        }
+
         if (event.type == sf::Event::KeyPressed) {
             firstTimeKeyPresses_.insert(event.key.code);
         }
@@ -48,7 +66,7 @@ UIAction InputManager::handleInput() {
         // catch the resize events
         if (event.type == sf::Event::Resized)
         {
-            dispatcher_.enqueue(ResizeWindow {event.size.width, event.size.height });
+            enqueueEvent(registry_, dispatcher_, ResizeWindow {event.size.width, event.size.height });
         }
     }
 
@@ -69,13 +87,13 @@ UIAction InputManager::handleInput() {
             // TODO: Find a way to automate this during compile time
 
             if(auto* jump = std::get_if<Jump>(&kv.second)) {
-                dispatcher_.enqueue(Event(entity, *jump));
+                enqueueEvent(registry_, dispatcher_, Event(entity, *jump));
             }
 
             if(auto* fireRope = std::get_if<FireRope>(&kv.second)) {
                 auto event = Event(entity, *fireRope);
-                event.eventDef.target = window_.mapPixelToCoords(sf::Mouse::getPosition(window_));
-                dispatcher_.enqueue(event);
+                event.eventDef.target = window_.mapPixelToCoords(sf::Mouse::getPosition(window_), camera);
+                enqueueEvent(registry_, dispatcher_, event);
             }
         }
     }
@@ -113,3 +131,21 @@ void InputManager::handleMovement(entt::entity entity, InputAction action, Movem
 void InputManager::operator()(InputAction action) const {
 
 }
+
+void InputManager::toggleTracing() {
+    if (!Tracer::isEnabled()) {
+        Tracer::clear();
+        Tracer::setEnabled(true);
+        SPDLOG_LOGGER_INFO(log_, "Started tracing, press F9 again to write the trace");
+        return;
+    }
+
+    Tracer::setEnabled(false);
+
+    try {
+        Tracer::dump(TRACE_PATH);
+        SPDLOG_LOGGER_INFO(log_, "Wrote trace to {}, open it in chrome://tracing or Perfetto", TRACE_PATH);
+    } catch (const std::runtime_error& error) {
+        SPDLOG_LOGGER_ERROR(log_, "Could not write trace: {}", error.what());
+    }
+}
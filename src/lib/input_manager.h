@@ -14,6 +14,7 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 #include "misc_components.h"
 #include "events.h"
+#include "logging.h"
 
 enum class InputAction {
     WALK_RIGHT,
@@ -58,7 +59,11 @@ using InputComponent = std::unordered_map<InputButton, std::variant<InputAction,
 class InputManager {
 public:
     InputManager(sf::RenderWindow&, entt::dispatcher& dispatcher, entt::dispatcher& sceneDispatcher, entt::registry&);
-    UIAction handleInput();
+    /**
+     * @param camera the view the world is drawn through, the window's own view belongs to
+     *        whichever thread is drawing
+     */
+    UIAction handleInput(const sf::View& camera);
     void handleMovement(entt::entity entity, InputAction action, Movement &movement);
 
     bool operator() (sf::Keyboard::Key) const;
@@ -68,12 +73,21 @@ public:
     void operator() (InputAction action) const;
 
 private:
+    static const sf::Keyboard::Key FRAME_STATS_KEY;
+
+    // Starts tracing, then stops it and writes the trace to TRACE_PATH
+    static const sf::Keyboard::Key TRACE_KEY;
+    static const std::string TRACE_PATH;
+
     sf::RenderWindow& window_;
     entt::registry& registry_;
     entt::dispatcher& dispatcher_;
     entt::dispatcher& sceneDispatcher_;
     std::set<sf::Keyboard::Key> firstTimeKeyPresses_;
     std::set<sf::Mouse::Button> firstTimeButtonPresses_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::INPUT);
+
+    void toggleTracing();
 };
 
 
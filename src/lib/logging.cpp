@@ -0,0 +1,84 @@
+//
+// Created by derek on 27/11/20.
+//
+
+#include "logging.h"
+
+#include <chrono>
+#include <mutex>
+
+#include <spdlog/async.h>
+#include <spdlog/cfg/env.h>
+#include <spdlog/cfg/helpers.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+const std::size_t Logging::QUEUE_SIZE = 8192;
+const std::string Logging::PATTERN = "%Y-%m-%d %H:%M:%S.%e %! [%n] [%l] %v";
+
+const std::string Logging::CHECKPOINTS = "checkpoints";
+const std::string Logging::INPUT = "input";
+const std::string Logging::MAP = "map";
+const std::string Logging::RENDER = "render";
+const std::string Logging::SCENES = "scenes";
+
+namespace {
+    const std::string DEFAULT_LOGGER = "slinger";
+
+    // Anything sitting in the console's buffer is written out at least this often
+    const auto FLUSH_INTERVAL = std::chrono::seconds(1);
+
+    std::mutex categoriesMutex;
+}
+
+void Logging::init(Overflow overflow, spdlog::level::level_enum level, std::size_t queueSize) {
+    spdlog::init_thread_pool(queueSize, 1);
+
+    auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    auto logger = std::make_shared<spdlog::async_logger>(
+        DEFAULT_LOGGER,
+        sink,
+        spdlog::thread_pool(),
+        overflow == Overflow::BLOCK ? spdlog::async_overflow_policy::block : spdlog::async_overflow_policy::overrun_oldest
+    );
+
+    spdlog::set_default_logger(logger);
+    spdlog::set_pattern(PATTERN);
+    spdlog::set_level(level);
+    spdlog::flush_on(spdlog::level::err);
+    spdlog::flush_every(FLUSH_INTERVAL);
+
+    spdlog::cfg::load_env_levels();
+}
+
+void Logging::setLevels(const std::string &levels) {
+    spdlog::cfg::helpers::load_levels(levels);
+}
+
+std::shared_ptr<spdlog::logger> Logging::get(const std::string &category) {
+    std::lock_guard<std::mutex> lock(categoriesMutex);
+
+    if (auto logger = spdlog::get(category)) {
+        return logger;
+    }
+
+    // Share the default logger's sinks, and its queue once init has made it asynchronous
+    auto logger = spdlog::default_logger()->clone(category);
+    spdlog::initialize_logger(logger);
+
+    return logger;
+}
+
+std::size_t Logging::droppedMessages() {
+    auto pool = spdlog::thread_pool();
+
+    return pool ? pool->overrun_counter() : 0;
+}
+
+void Logging::shutdown() {
+    if (auto dropped = droppedMessages()) {
+        spdlog::warn("Dropped {} log messages because the queue was full", dropped);
+    }
+
+    spdlog::shutdown();
+}
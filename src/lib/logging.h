@@ -0,0 +1,70 @@
+//
+// Created by derek on 27/11/20.
+//
+
+#ifndef SLINGER_LOGGING_H
+#define SLINGER_LOGGING_H
+
+#include <memory>
+#include <string>
+
+#include <spdlog/logger.h>
+
+/**
+ * Sets up the loggers every part of the game writes through. After init, messages are put on a
+ * bounded queue and formatted and written by a background thread, so logging never waits on the
+ * console in the middle of a frame.
+ *
+ * Each part of the game logs under a category with its own level. Levels are read from the
+ * SPDLOG_LEVEL environment variable, such as SPDLOG_LEVEL=info,checkpoints=warn,map=debug
+ */
+class Logging {
+public:
+    enum class Overflow {
+        // Wait for the queue to have room, nothing is lost but a full queue stalls the frame
+        BLOCK,
+
+        // Throw away the oldest queued message to make room
+        DROP
+    };
+
+    static const std::size_t QUEUE_SIZE;
+    static const std::string PATTERN;
+
+    static const std::string CHECKPOINTS;
+    static const std::string INPUT;
+    static const std::string MAP;
+    static const std::string RENDER;
+    static const std::string SCENES;
+
+    /**
+     * Replace the default logger with one that logs in the background, any category made
+     * afterwards does the same. Levels from the environment are applied on top of the given one.
+     */
+    static void init(Overflow overflow = Overflow::DROP, spdlog::level::level_enum level = spdlog::level::info,
+        std::size_t queueSize = QUEUE_SIZE);
+
+    /**
+     * Set levels in the same form as SPDLOG_LEVEL, categories not mentioned keep theirs
+     */
+    static void setLevels(const std::string& levels);
+
+    /**
+     * The logger for a category, made the first time it is asked for. Keep hold of it rather
+     * than asking every time something is logged.
+     */
+    static std::shared_ptr<spdlog::logger> get(const std::string& category);
+
+    /**
+     * How many messages have been thrown away because the queue was full
+     */
+    static std::size_t droppedMessages();
+
+    /**
+     * Write out everything still queued and stop the background thread
+     */
+    static void shutdown();
+};
+
+
+#endif //SLINGER_LOGGING_H
@@ -0,0 +1,110 @@
+//
+// Created by derek on 19/11/20.
+//
+
+#include "endless_generator.h"
+
+#include <cmath>
+#include <random>
+
+const float EndlessGenerator::CHUNK_WIDTH = 40.f;
+const float EndlessGenerator::CHUNK_HEIGHT = 40.f;
+const float EndlessGenerator::WALL_THICKNESS = 2.f;
+const float EndlessGenerator::GRID = 0.5f;
+
+const int EndlessGenerator::ANCHORS_PER_CHUNK = 5;
+const float EndlessGenerator::LEDGE_WIDTH = 4.f;
+const float EndlessGenerator::SPIKE_CHANCE = 0.3f;
+
+EndlessGenerator::EndlessGenerator(std::uint32_t seed): seed_(seed) {
+
+}
+
+LevelData EndlessGenerator::generate(std::size_t index) const {
+    // Mix the index into the seed so neighbouring chunks don't share a sequence
+    std::seed_seq sequence { seed_, (std::uint32_t) index, (std::uint32_t) ((std::uint64_t) index >> 32u) };
+    std::mt19937 random(sequence);
+
+    const float base = (float) index * CHUNK_HEIGHT;
+    const float halfWidth = CHUNK_WIDTH / 2.f;
+    const int gridWidth = (int) (CHUNK_WIDTH / GRID);
+
+    LevelData chunk;
+    chunk.spawn = getSpawn();
+
+    // Side walls, each chunk's walls meet the ones of the chunks above and below
+    for (float side : { -1.f, 1.f }) {
+        chunk.walls.push_back(makeRect(
+            side * (halfWidth + WALL_THICKNESS / 2.f),
+            base + CHUNK_HEIGHT / 2.f,
+            WALL_THICKNESS,
+            CHUNK_HEIGHT
+        ));
+    }
+
+    if (index == 0) {
+        chunk.walls.push_back(makeRect(0, -WALL_THICKNESS / 2.f, CHUNK_WIDTH, WALL_THICKNESS));
+    }
+
+    // A ledge in the middle with a checkpoint across the whole width above it, so climbing
+    // through a chunk always moves the respawn up and there is always something to land on
+    chunk.walls.push_back(makeRect(0, base + 0.5f, LEDGE_WIDTH, 1.f));
+
+    LevelCheckpoint checkpoint;
+    checkpoint.shape = makeRect(0, base + 1.5f, CHUNK_WIDTH, 1.f);
+    chunk.checkpoints.push_back(checkpoint);
+
+    // Blocks to swing from, spread evenly up the chunk
+    std::uniform_int_distribution<int> widthCells(2, 6);
+    std::uniform_int_distribution<int> heightCells(1, 2);
+    std::uniform_real_distribution<float> chance(0.f, 1.f);
+
+    const float spacing = CHUNK_HEIGHT / (float) ANCHORS_PER_CHUNK;
+
+    for (int i = 0; i < ANCHORS_PER_CHUNK; i++) {
+        float width = (float) widthCells(random) * 2.f * GRID;
+        float height = (float) heightCells(random) * 2.f * GRID;
+
+        int margin = (int) std::ceil(width / 2.f / GRID);
+        std::uniform_int_distribution<int> column(margin, gridWidth - margin);
+        float x = (float) column(random) * GRID - halfWidth;
+        float y = base + spacing * ((float) i + 0.5f) + spacing / 4.f;
+
+        chunk.walls.push_back(makeRect(x, y, width, height));
+
+        // Spikes on top of some blocks, never in the first chunk so the start is always safe
+        if (index > 0 && chance(random) < SPIKE_CHANCE) {
+            LevelDeathZone zone;
+            zone.shape = makeRect(x, y + height / 2.f + GRID / 2.f, width, GRID);
+            zone.spikes = true;
+
+            chunk.deathZones.push_back(zone);
+        }
+    }
+
+    return chunk;
+}
+
+sf::Vector2f EndlessGenerator::getSpawn() const {
+    return sf::Vector2f(0, 3);
+}
+
+std::uint32_t EndlessGenerator::getSeed() const {
+    return seed_;
+}
+
+std::size_t EndlessGenerator::chunkAt(float y) {
+    if (y <= 0) {
+        return 0;
+    }
+
+    return (std::size_t) std::floor(y / CHUNK_HEIGHT);
+}
+
+LevelShape EndlessGenerator::makeRect(float x, float y, float width, float height) {
+    LevelShape shape;
+    shape.type = LevelShape::Type::RECT;
+    shape.rect = Dimensions { x, y, width, height };
+
+    return shape;
+}
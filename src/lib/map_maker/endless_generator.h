@@ -0,0 +1,49 @@
+//
+// Created by derek on 19/11/20.
+//
+
+#ifndef SLINGER_ENDLESS_GENERATOR_H
+#define SLINGER_ENDLESS_GENERATOR_H
+
+#include <cstdint>
+
+#include "level_data.h"
+
+/**
+ * Makes the chunks of an endless climb. Chunks are stacked on top of each other, chunk 0 sits on
+ * the ground and holds the spawn. Each chunk only depends on the seed and its index, so they can
+ * be generated in any order and on any thread.
+ */
+class EndlessGenerator {
+    std::uint32_t seed_;
+
+public:
+    static const float CHUNK_WIDTH;
+    static const float CHUNK_HEIGHT;
+    static const float WALL_THICKNESS;
+
+    // Every generated size and position is a multiple of this, so only a handful of distinct
+    // meshes are ever made and the mesh cache stops growing however long the climb goes on
+    static const float GRID;
+
+    explicit EndlessGenerator(std::uint32_t seed);
+
+    [[nodiscard]] LevelData generate(std::size_t index) const;
+    [[nodiscard]] sf::Vector2f getSpawn() const;
+    [[nodiscard]] std::uint32_t getSeed() const;
+
+    /**
+     * The chunk a height is in, heights below the ground are in chunk 0
+     */
+    static std::size_t chunkAt(float y);
+
+private:
+    static const int ANCHORS_PER_CHUNK;
+    static const float LEDGE_WIDTH;
+    static const float SPIKE_CHANCE;
+
+    static LevelShape makeRect(float x, float y, float width, float height);
+};
+
+
+#endif //SLINGER_ENDLESS_GENERATOR_H
@@ -0,0 +1,141 @@
+//
+// Created by derek on 19/11/20.
+//
+
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+
+#include "endless_map.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <spdlog/spdlog.h>
+
+const std::size_t EndlessMap::CHUNKS_AHEAD = 2;
+const std::size_t EndlessMap::CHUNKS_BEHIND = 1;
+const float EndlessMap::KILL_FLOOR_DEPTH = 10.f;
+
+EndlessMap::EndlessMap(entt::registry &registry, Physics &physics, MapShapeBuilder &builder):
+    scenery_(registry, physics, builder),
+    generator_(0)
+{
+
+}
+
+EndlessMap::~EndlessMap() {
+    if (generating_.valid()) {
+        generating_.wait();
+    }
+}
+
+void EndlessMap::start(std::uint32_t seed) {
+    clear();
+
+    generator_ = EndlessGenerator(seed);
+    commit(0, generator_.generate(0));
+    nextIndex_ = 1;
+
+    SPDLOG_LOGGER_INFO(log_, "Started endless climb with seed {}", seed);
+}
+
+void EndlessMap::update(const sf::Vector2f &focus, const sf::Vector2f &respawn, ThreadPool *pool) {
+    if (chunks_.empty()) {
+        return;
+    }
+
+    auto focusChunk = EndlessGenerator::chunkAt(focus.y);
+
+    if (generating_.valid()) {
+        // The chunk is only waited for if the player has somehow caught up with it
+        auto status = generating_.wait_for(std::chrono::seconds(0));
+        bool needed = nextIndex_ <= focusChunk + 1;
+
+        if (status == std::future_status::timeout && needed) {
+            SPDLOG_LOGGER_WARN(log_, "Waiting for chunk {} to finish generating", nextIndex_);
+        }
+
+        if (status != std::future_status::timeout || needed) {
+            commit(nextIndex_, generating_.get());
+            nextIndex_++;
+        }
+    }
+
+    if (!generating_.valid() && nextIndex_ <= focusChunk + CHUNKS_AHEAD) {
+        // The generator is copied so the task doesn't depend on anything here staying alive
+        auto generate = [generator = generator_, index = nextIndex_]() {
+            return generator.generate(index);
+        };
+
+        generating_ = pool ? pool->submit(generate) : std::async(std::launch::deferred, generate);
+    }
+
+    // Falling back down keeps the chunks below, as does a checkpoint that is far behind
+    auto keepFrom = std::min(focusChunk, EndlessGenerator::chunkAt(respawn.y));
+    keepFrom = keepFrom > CHUNKS_BEHIND ? keepFrom - CHUNKS_BEHIND : 0;
+
+    bool retired = false;
+    while (chunks_.size() > 1 && chunks_.front().index < keepFrom && !scenery_.isHeld(chunks_.front().entities)) {
+        SPDLOG_LOGGER_DEBUG(log_, "Retiring chunk {} with {} entities", chunks_.front().index, chunks_.front().entities.size());
+
+        scenery_.remove(chunks_.front().entities);
+        chunks_.pop_front();
+        retired = true;
+    }
+
+    if (retired) {
+        moveKillFloor();
+    }
+}
+
+sf::Vector2f EndlessMap::getSpawn() const {
+    return generator_.getSpawn();
+}
+
+std::size_t EndlessMap::chunkCount() const {
+    return chunks_.size();
+}
+
+bool EndlessMap::isRunning() const {
+    return !chunks_.empty();
+}
+
+void EndlessMap::clear() {
+    if (generating_.valid()) {
+        generating_.wait();
+        generating_ = std::future<LevelData>();
+    }
+
+    for (auto &chunk : chunks_) {
+        scenery_.remove(chunk.entities);
+    }
+
+    chunks_.clear();
+    scenery_.remove(killFloor_);
+    nextIndex_ = 0;
+}
+
+void EndlessMap::commit(std::size_t index, const LevelData &chunk) {
+    chunks_.push_back(Chunk { index, scenery_.add(chunk) });
+
+    if (chunks_.size() == 1) {
+        moveKillFloor();
+    }
+
+    SPDLOG_LOGGER_DEBUG(log_, "Added chunk {} with {} entities", index, chunks_.back().entities.size());
+}
+
+void EndlessMap::moveKillFloor() {
+    scenery_.remove(killFloor_);
+
+    // Wide enough to catch anything that gets outside the side walls
+    auto width = EndlessGenerator::CHUNK_WIDTH * 2.f;
+    auto y = (float) chunks_.front().index * EndlessGenerator::CHUNK_HEIGHT - KILL_FLOOR_DEPTH;
+
+    LevelData floor;
+    LevelDeathZone zone;
+    zone.shape.type = LevelShape::Type::RECT;
+    zone.shape.rect = Dimensions { 0, y, width, 1.f };
+    floor.deathZones.push_back(zone);
+
+    killFloor_ = scenery_.add(floor);
+}
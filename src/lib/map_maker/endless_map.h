@@ -0,0 +1,81 @@
+//
+// Created by derek on 19/11/20.
+//
+
+#ifndef SLINGER_ENDLESS_MAP_H
+#define SLINGER_ENDLESS_MAP_H
+
+#include <deque>
+#include <future>
+#include <vector>
+
+#include <entt/entity/registry.hpp>
+
+#include "endless_generator.h"
+#include "logging.h"
+#include "scenery_tracker.h"
+#include "thread_pool.h"
+
+/**
+ * Keeps an endless climb in the world around the followed entity. The next chunk is generated
+ * on a worker thread while the player is still a couple of chunks below it and is only added
+ * to the world on update, between physics steps. Chunks below the player and their last
+ * checkpoint are removed again, along with the floor that kills anything falling past them,
+ * so the number of chunks in the world stays the same however high the player gets.
+ */
+class EndlessMap {
+    struct Chunk {
+        std::size_t index;
+        std::vector<entt::entity> entities;
+    };
+
+    SceneryTracker scenery_;
+    EndlessGenerator generator_;
+
+    std::deque<Chunk> chunks_;
+    std::vector<entt::entity> killFloor_;
+
+    // Only one chunk is generated at a time, so at most one is ever waiting to be added
+    std::future<LevelData> generating_;
+    std::size_t nextIndex_ = 0;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::MAP);
+
+public:
+    // How many chunks above the one the player is in are kept ready
+    static const std::size_t CHUNKS_AHEAD;
+
+    // How many chunks below the player, or their last checkpoint, are kept
+    static const std::size_t CHUNKS_BEHIND;
+
+    // How far below the lowest chunk the kill floor sits
+    static const float KILL_FLOOR_DEPTH;
+
+    EndlessMap(entt::registry& registry, Physics& physics, MapShapeBuilder& builder);
+    ~EndlessMap();
+
+    /**
+     * Start a new climb, removing any chunks already in the world and adding the first one
+     */
+    void start(std::uint32_t seed);
+
+    /**
+     * Add a chunk that has finished generating, start generating the next one if the player is
+     * getting close to it and remove chunks that have been left behind
+     * @param respawn where the followed entity will respawn, chunks above this are never removed
+     * @param pool generates chunks in the background, without one they are generated when needed
+     */
+    void update(const sf::Vector2f& focus, const sf::Vector2f& respawn, ThreadPool* pool = nullptr);
+
+    [[nodiscard]] sf::Vector2f getSpawn() const;
+    [[nodiscard]] std::size_t chunkCount() const;
+    [[nodiscard]] bool isRunning() const;
+
+    void clear();
+
+private:
+    void commit(std::size_t index, const LevelData& chunk);
+    void moveKillFloor();
+};
+
+
+#endif //SLINGER_ENDLESS_MAP_H
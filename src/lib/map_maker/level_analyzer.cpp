@@ -0,0 +1,292 @@
+//
+// Created by derek on 20/11/20.
+//
+
+#include "level_analyzer.h"
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+
+#include <box2d/box2d.h>
+#include <entt/entt.hpp>
+#include <pugixml.hpp>
+
+#include "level_reader.h"
+#include "map_maker.h"
+#include "mapped_file.h"
+#include "mesh_cache.h"
+#include "simplifier.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::size_t countFixtures(b2World &world) {
+        std::size_t count = 0;
+
+        for (auto *body = world.GetBodyList(); body; body = body->GetNext()) {
+            for (auto *fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+                count++;
+            }
+        }
+
+        return count;
+    }
+
+    std::size_t sum(const std::vector<std::size_t> &values) {
+        std::size_t total = 0;
+        for (auto value : values) {
+            total += value;
+        }
+
+        return total;
+    }
+
+    std::size_t max(const std::vector<std::size_t> &values) {
+        std::size_t largest = 0;
+        for (auto value : values) {
+            largest = std::max(largest, value);
+        }
+
+        return largest;
+    }
+}
+
+std::map<std::string, double> LevelReport::metrics() const {
+    std::map<std::string, double> metrics {
+        { "bodies", (double) bodies },
+        { "fixtures", (double) fixtures },
+        { "proxies", (double) proxies },
+        { "load_ms.xml_parse", xmlParseMs },
+        { "load_ms.level_read", levelReadMs },
+        { "load_ms.body_creation", bodyCreationMs },
+        { "load_ms.total", xmlParseMs + levelReadMs + bodyCreationMs },
+    };
+
+    std::size_t drawables = 0;
+    for (const auto &[zIndex, count] : drawablesPerZIndex) {
+        metrics["drawables.z" + std::to_string(zIndex)] = (double) count;
+        drawables += count;
+    }
+
+    metrics["drawables"] = (double) drawables;
+
+    for (const auto &[name, layer] : layers) {
+        auto prefix = "layers." + name + ".";
+
+        metrics[prefix + "shapes"] = (double) layer.shapes;
+        metrics[prefix + "polygons"] = (double) layer.polygons;
+        metrics[prefix + "bodies"] = (double) layer.bodies;
+        metrics[prefix + "fixtures"] = (double) layer.fixtures;
+        metrics[prefix + "triangles"] = (double) layer.triangles;
+        metrics[prefix + "vertices"] = (double) sum(layer.polygonVertices);
+        metrics[prefix + "max_polygon_vertices"] = (double) max(layer.polygonVertices);
+        metrics[prefix + "max_collision_vertices"] = (double) max(layer.collisionVertices);
+        metrics[prefix + "hulled"] = (double) layer.hulled;
+        metrics[prefix + "over_vertex_limit"] = (double) layer.overVertexLimit;
+    }
+
+    return metrics;
+}
+
+nlohmann::json LevelReport::toJson() const {
+    nlohmann::json json;
+    json["name"] = name;
+    json["metrics"] = metrics();
+
+    for (const auto &[layerName, layer] : layers) {
+        json["layers"][layerName] = {
+            { "shapes", layer.shapes },
+            { "rects", layer.rects },
+            { "polygons", layer.polygons },
+            { "bodies", layer.bodies },
+            { "fixtures", layer.fixtures },
+            { "triangles", layer.triangles },
+            { "polygon_vertices", layer.polygonVertices },
+            { "collision_vertices", layer.collisionVertices },
+            { "hulled", layer.hulled },
+            { "over_vertex_limit", layer.overVertexLimit },
+        };
+    }
+
+    for (const auto &[zIndex, count] : drawablesPerZIndex) {
+        json["drawables_per_z_index"][std::to_string(zIndex)] = count;
+    }
+
+    return json;
+}
+
+LevelReport LevelAnalyzer::analyze(const std::string &path) {
+    MappedFile file(path);
+    return analyze(file.data(), file.size(), path);
+}
+
+LevelReport LevelAnalyzer::analyze(const char *data, std::size_t size, const std::string &name) {
+    LevelReport report;
+    report.name = name;
+
+    auto start = Clock::now();
+    pugi::xml_document doc;
+    if (!doc.load_buffer(data, size)) {
+        throw std::runtime_error("could not parse level: " + name);
+    }
+    report.xmlParseMs = millisecondsSince(start);
+
+    // Everything the reader does to the parsed document, flattening paths, triangulating and
+    // simplifying. Read on this thread so the timing is the cost of the content rather than the pool
+    start = Clock::now();
+    auto level = LevelReader::read(doc, name);
+    report.levelReadMs = millisecondsSince(start);
+
+    entt::registry registry;
+    entt::dispatcher dispatcher;
+    Physics physics(registry, dispatcher);
+    MapShapeBuilder builder(registry, physics);
+    auto &world = physics.getWorld();
+
+    // Build each layer the same way MapMaker does, measuring the world as it grows
+    auto build = [&](const std::string &layerName, const std::function<void()> &make) {
+        auto &layer = report.layers[layerName];
+        auto bodies = (std::size_t) world.GetBodyCount();
+        auto fixtures = countFixtures(world);
+
+        auto layerStart = Clock::now();
+        make();
+        report.bodyCreationMs += millisecondsSince(layerStart);
+
+        layer.bodies = world.GetBodyCount() - bodies;
+        layer.fixtures = countFixtures(world) - fixtures;
+    };
+
+    auto tolerance = builder.getCollisionTolerance();
+
+    build("walls", [&]() {
+        for (const auto &wall : level.walls) {
+            builder.makeWall(wall);
+            addShape(report.layers["walls"], wall, tolerance);
+        }
+    });
+
+    build("death_zones", [&]() {
+        for (const auto &zone : level.deathZones) {
+            builder.makeDeathZone(zone);
+            addShape(report.layers["death_zones"], zone.shape, tolerance);
+        }
+    });
+
+    build("checkpoints", [&]() {
+        for (const auto &checkpoint : level.checkpoints) {
+            builder.makeCheckpoint(checkpoint);
+            addShape(report.layers["checkpoints"], checkpoint.shape, tolerance);
+        }
+    });
+
+    build("decorations", [&]() {
+        for (const auto &decoration : level.decorations) {
+            builder.makeDecoration(decoration);
+            addShape(report.layers["decorations"], decoration, tolerance);
+        }
+    });
+
+    build("objects", [&]() {
+        builder.makePlayer(level.spawn);
+    });
+
+    report.bodies = world.GetBodyCount();
+    report.fixtures = countFixtures(world);
+    report.proxies = world.GetProxyCount();
+
+    registry.view<Drawable>().each([&report](const auto entity, const Drawable &drawable) {
+        report.drawablesPerZIndex[drawable.zIndex]++;
+    });
+
+    return report;
+}
+
+std::vector<std::string> LevelAnalyzer::checkBudgets(const LevelReport &report, const Budgets &budgets) {
+    std::vector<std::string> failures;
+    auto metrics = report.metrics();
+
+    for (const auto &[name, limit] : budgets) {
+        auto metric = metrics.find(name);
+
+        if (metric == metrics.end()) {
+            failures.push_back("no metric called " + name);
+        } else if (metric->second > limit) {
+            failures.push_back(name + " is " + std::to_string(metric->second) + ", over its budget of " + std::to_string(limit));
+        }
+    }
+
+    return failures;
+}
+
+LevelAnalyzer::Budgets LevelAnalyzer::readBudgets(const std::string &path) {
+    std::ifstream input(path);
+    if (!input) {
+        throw std::runtime_error("Could not open budgets: " + path);
+    }
+
+    nlohmann::json json;
+    input >> json;
+
+    Budgets budgets;
+    for (const auto &[name, limit] : json.items()) {
+        if (!limit.is_number()) {
+            throw std::runtime_error("Budget for " + name + " is not a number");
+        }
+
+        budgets[name] = limit.get<double>();
+    }
+
+    return budgets;
+}
+
+void LevelAnalyzer::addShape(LayerReport &layer, const LevelShape &shape, float collisionTolerance) {
+    layer.shapes++;
+
+    if (shape.type == LevelShape::Type::RECT) {
+        layer.rects++;
+        return;
+    }
+
+    const auto &polygon = shape.polygon;
+    layer.polygons++;
+    layer.triangles += polygon.mesh.indices.size() / 3;
+
+    // Physics simplifies the outline before handing it to b2PolygonShape::Set
+    auto collision = Simplifier::simplify(polygon.outline, collisionTolerance);
+    if (collision.size() > 1 && collision.front() == collision.back()) {
+        collision.pop_back();
+    }
+
+    layer.polygonVertices.push_back(polygon.outline.size());
+    layer.collisionVertices.push_back(collision.size());
+
+    if (collision.size() > b2_maxPolygonVertices) {
+        layer.overVertexLimit++;
+    } else if (!isConvex(collision)) {
+        layer.hulled++;
+    }
+}
+
+bool LevelAnalyzer::isConvex(const std::vector<sf::Vector2f> &points) {
+    bool positive = false;
+    bool negative = false;
+
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const auto &a = points[i];
+        const auto &b = points[(i + 1) % points.size()];
+        const auto &c = points[(i + 2) % points.size()];
+
+        float cross = (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+        positive = positive || cross > 0;
+        negative = negative || cross < 0;
+    }
+
+    return !(positive && negative);
+}
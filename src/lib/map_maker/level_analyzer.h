@@ -0,0 +1,86 @@
+//
+// Created by derek on 20/11/20.
+//
+
+#ifndef SLINGER_LEVEL_ANALYZER_H
+#define SLINGER_LEVEL_ANALYZER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "level_data.h"
+
+/**
+ * How much a single layer of a level costs
+ */
+struct LayerReport {
+    std::size_t shapes = 0;
+    std::size_t rects = 0;
+    std::size_t polygons = 0;
+    std::size_t bodies = 0;
+    std::size_t fixtures = 0;
+    std::size_t triangles = 0;
+
+    // The outline of each polygon before and after it is simplified for collision
+    std::vector<std::size_t> polygonVertices;
+    std::vector<std::size_t> collisionVertices;
+
+    // Concave polygons that box2d wraps in a convex hull, so they don't collide like they look
+    std::size_t hulled = 0;
+
+    // Polygons with more vertices than box2d takes, which assert in a debug build of box2d and
+    // lose every vertex past the limit in a release build
+    std::size_t overVertexLimit = 0;
+};
+
+struct LevelReport {
+    std::string name;
+    std::map<std::string, LayerReport> layers;
+    std::map<int, std::size_t> drawablesPerZIndex;
+    std::size_t bodies = 0;
+    std::size_t fixtures = 0;
+    std::size_t proxies = 0;
+
+    // Timings depend on the machine, so they are reported but only budgeted when asked to be
+    double xmlParseMs = 0;
+    double levelReadMs = 0;
+    double bodyCreationMs = 0;
+
+    /**
+     * Every number in the report by a dotted name, these are what budgets are checked against
+     */
+    [[nodiscard]] std::map<std::string, double> metrics() const;
+    [[nodiscard]] nlohmann::json toJson() const;
+};
+
+/**
+ * Loads a level into a world of its own, without a window or textures, and measures it
+ */
+class LevelAnalyzer {
+public:
+    using Budgets = std::map<std::string, double>;
+
+    static LevelReport analyze(const std::string& path);
+    static LevelReport analyze(const char* data, std::size_t size, const std::string& name);
+
+    /**
+     * Compare a report to the largest each metric is allowed to be
+     * @return a message for each metric over budget, budgets for unknown metrics also fail
+     */
+    static std::vector<std::string> checkBudgets(const LevelReport& report, const Budgets& budgets);
+
+    /**
+     * Read budgets from a json object of metric names to limits
+     */
+    static Budgets readBudgets(const std::string& path);
+
+private:
+    static void addShape(LayerReport& layer, const LevelShape& shape, float collisionTolerance);
+    static bool isConvex(const std::vector<sf::Vector2f>& points);
+};
+
+
+#endif //SLINGER_LEVEL_ANALYZER_H
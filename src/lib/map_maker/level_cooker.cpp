@@ -0,0 +1,638 @@
+//
+// Created by derek on 14/11/20.
+//
+
+#include "level_cooker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+
+#include <spdlog/spdlog.h>
+
+#include "level_reader.h"
+#include "logging.h"
+#include "path_builder.h"
+
+const char LevelCooker::MAGIC[4] = { 'S', 'L', 'V', 'L' };
+const std::uint32_t LevelCooker::VERSION = 3;
+const std::string LevelCooker::COOKED_EXTENSION = ".cooked";
+const float LevelCooker::PAGE_SIZE = 64.f;
+
+namespace {
+    /**
+     * Appends values in native byte order, cooked levels are a cache for this machine not a
+     * format to share
+     */
+    class Writer {
+        std::vector<char>& out_;
+
+    public:
+        explicit Writer(std::vector<char>& out): out_(out) {
+
+        }
+
+        template <class T>
+        void value(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            auto bytes = reinterpret_cast<const char*>(&value);
+            out_.insert(out_.end(), bytes, bytes + sizeof(T));
+        }
+
+        template <class T>
+        void array(const std::vector<T>& values) {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            value((std::uint32_t) values.size());
+
+            auto bytes = reinterpret_cast<const char*>(values.data());
+            out_.insert(out_.end(), bytes, bytes + values.size() * sizeof(T));
+        }
+
+        void mesh(const Mesh& mesh) {
+            array(mesh.vertices);
+            array(mesh.indices);
+        }
+
+        void shape(const LevelShape& shape) {
+            value(shape.type);
+
+            if (shape.type == LevelShape::Type::RECT) {
+                value(shape.rect);
+                return;
+            }
+
+            array(shape.polygon.outline);
+            mesh(shape.polygon.mesh);
+
+            value((std::uint32_t) shape.polygon.detailLevels.size());
+            for (const auto &detail : shape.polygon.detailLevels) {
+                value(detail.tolerance);
+                mesh(detail.mesh);
+            }
+        }
+
+        void scenery(const LevelData& level) {
+            value((std::uint32_t) level.walls.size());
+            for (const auto &wall : level.walls) {
+                shape(wall);
+            }
+
+            value((std::uint32_t) level.deathZones.size());
+            for (const auto &zone : level.deathZones) {
+                shape(zone.shape);
+                value((std::uint8_t) zone.spikes);
+            }
+
+            value((std::uint32_t) level.checkpoints.size());
+            for (const auto &checkpoint : level.checkpoints) {
+                shape(checkpoint.shape);
+                value((std::uint8_t) checkpoint.finish);
+            }
+
+            value((std::uint32_t) level.decorations.size());
+            for (const auto &decoration : level.decorations) {
+                shape(decoration);
+            }
+        }
+    };
+
+    /**
+     * Reads back what Writer wrote, every array is a single copy out of the buffer
+     */
+    class Reader {
+        const char* data_;
+        std::size_t size_;
+        std::size_t position_ = 0;
+
+    public:
+        Reader(const char* data, std::size_t size): data_(data), size_(size) {
+
+        }
+
+        template <class T>
+        T value() {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            T value;
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+
+            return value;
+        }
+
+        template <class T>
+        std::vector<T> array() {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            // Check the data is all there before allocating anything for it
+            auto count = value<std::uint32_t>();
+            auto bytes = take(count * sizeof(T));
+
+            std::vector<T> values(count);
+            if (count > 0) {
+                std::memcpy(values.data(), bytes, count * sizeof(T));
+            }
+
+            return values;
+        }
+
+        Mesh mesh() {
+            Mesh mesh;
+            mesh.vertices = array<sf::Vector2f>();
+            mesh.indices = array<std::uint32_t>();
+
+            return mesh;
+        }
+
+        LevelShape shape() {
+            LevelShape shape;
+            shape.type = value<LevelShape::Type>();
+
+            if (shape.type == LevelShape::Type::RECT) {
+                shape.rect = value<Dimensions>();
+                return shape;
+            }
+
+            if (shape.type != LevelShape::Type::POLYGON) {
+                throw std::runtime_error("Unknown shape type in cooked level");
+            }
+
+            shape.polygon.outline = array<sf::Vector2f>();
+            shape.polygon.mesh = mesh();
+
+            auto detailCount = value<std::uint32_t>();
+            for (std::uint32_t i = 0; i < detailCount; i++) {
+                auto tolerance = value<float>();
+                shape.polygon.detailLevels.push_back(DetailMesh { tolerance, mesh() });
+            }
+
+            return shape;
+        }
+
+        /**
+         * Read the scenery of a page onto the end of what is already in the level
+         */
+        void scenery(LevelData& level) {
+            auto wallCount = value<std::uint32_t>();
+            for (std::uint32_t i = 0; i < wallCount; i++) {
+                level.walls.push_back(shape());
+            }
+
+            auto zoneCount = value<std::uint32_t>();
+            for (std::uint32_t i = 0; i < zoneCount; i++) {
+                auto zoneShape = shape();
+                level.deathZones.push_back(LevelDeathZone { std::move(zoneShape), value<std::uint8_t>() != 0 });
+            }
+
+            auto checkpointCount = value<std::uint32_t>();
+            for (std::uint32_t i = 0; i < checkpointCount; i++) {
+                auto checkpointShape = shape();
+                level.checkpoints.push_back(LevelCheckpoint { std::move(checkpointShape), value<std::uint8_t>() != 0 });
+            }
+
+            auto decorationCount = value<std::uint32_t>();
+            for (std::uint32_t i = 0; i < decorationCount; i++) {
+                level.decorations.push_back(shape());
+            }
+        }
+
+        [[nodiscard]] bool atEnd() const {
+            return position_ == size_;
+        }
+
+        [[nodiscard]] std::size_t position() const {
+            return position_;
+        }
+
+    private:
+        const char* take(std::size_t bytes) {
+            if (bytes > size_ - position_) {
+                throw std::runtime_error("Cooked level is truncated");
+            }
+
+            const char* start = data_ + position_;
+            position_ += bytes;
+
+            return start;
+        }
+    };
+
+    sf::FloatRect merge(const sf::FloatRect &lhs, const sf::FloatRect &rhs) {
+        auto left = std::min(lhs.left, rhs.left);
+        auto top = std::min(lhs.top, rhs.top);
+        auto right = std::max(lhs.left + lhs.width, rhs.left + rhs.width);
+        auto bottom = std::max(lhs.top + lhs.height, rhs.top + rhs.height);
+
+        return sf::FloatRect(left, top, right - left, bottom - top);
+    }
+
+    sf::FloatRect getBounds(const LevelShape &shape) {
+        if (shape.type == LevelShape::Type::RECT) {
+            const auto &rect = shape.rect;
+            return sf::FloatRect(rect.x - rect.width / 2.f, rect.y - rect.height / 2.f, rect.width, rect.height);
+        }
+
+        const auto &outline = shape.polygon.outline;
+        if (outline.empty()) {
+            return sf::FloatRect();
+        }
+
+        sf::FloatRect bounds(outline[0].x, outline[0].y, 0, 0);
+        for (const auto &point : outline) {
+            bounds = merge(bounds, sf::FloatRect(point.x, point.y, 0, 0));
+        }
+
+        return bounds;
+    }
+}
+
+CookedLevel::CookedLevel(std::unique_ptr<MappedFile> file): file_(std::move(file)) {
+
+}
+
+CookedLevel::CookedLevel(std::vector<char> buffer): buffer_(std::move(buffer)) {
+
+}
+
+const sf::Vector2f &CookedLevel::getSpawn() const {
+    return spawn_;
+}
+
+const std::vector<CookedPage> &CookedLevel::getPages() const {
+    return pages_;
+}
+
+LevelData CookedLevel::readPage(const CookedPage &page) const {
+    // The page table was checked against the size when it was read
+    Reader reader(data() + page.offset, (std::size_t) page.size);
+
+    LevelData level;
+    level.spawn = spawn_;
+    reader.scenery(level);
+
+    if (!reader.atEnd()) {
+        throw std::runtime_error("Cooked page has trailing data");
+    }
+
+    return level;
+}
+
+LevelData CookedLevel::readAll() const {
+    LevelData level;
+    level.spawn = spawn_;
+
+    for (const auto &page : pages_) {
+        Reader reader(data() + page.offset, (std::size_t) page.size);
+        reader.scenery(level);
+
+        if (!reader.atEnd()) {
+            throw std::runtime_error("Cooked page has trailing data");
+        }
+    }
+
+    return level;
+}
+
+const char *CookedLevel::data() const {
+    return file_ ? file_->data() : buffer_.data();
+}
+
+std::size_t CookedLevel::size() const {
+    return file_ ? file_->size() : buffer_.size();
+}
+
+CookedLevel LevelCooker::open(const std::string &svgPath, ThreadPool *pool) {
+    auto source = stat(svgPath);
+    auto cooked = cookedPath(svgPath);
+
+    // Nothing has touched the svg since it was cooked, so it doesn't need reading
+    if (auto level = loadCooked(cooked, source)) {
+        SPDLOG_LOGGER_INFO(logger(), "Loaded cooked level {}", cooked);
+        return std::move(level.value());
+    }
+
+    bool changed = false;
+    auto data = recook(svgPath, source, pool, changed);
+
+    // Failing to write the cache shouldn't stop the level from loading
+    try {
+        writeCooked(cooked, data);
+
+        if (auto level = loadCooked(cooked, source)) {
+            return std::move(level.value());
+        }
+    } catch (const std::runtime_error& error) {
+        SPDLOG_LOGGER_WARN(logger(), "Could not cook {}: {}", svgPath, error.what());
+    }
+
+    return index(std::move(data), source).value();
+}
+
+LevelData LevelCooker::load(const std::string &svgPath, ThreadPool *pool) {
+    return open(svgPath, pool).readAll();
+}
+
+bool LevelCooker::cook(const std::string &svgPath, ThreadPool *pool) {
+    auto source = stat(svgPath);
+    auto cooked = cookedPath(svgPath);
+
+    if (loadCooked(cooked, source)) {
+        return false;
+    }
+
+    bool changed = false;
+    writeCooked(cooked, recook(svgPath, source, pool, changed));
+
+    return changed;
+}
+
+std::string LevelCooker::cookedPath(const std::string &svgPath) {
+    return std::filesystem::path(svgPath).replace_extension(COOKED_EXTENSION).string();
+}
+
+std::uint64_t LevelCooker::hash(const char *data, std::size_t size) {
+    std::uint64_t hash = 14695981039346656037ull;
+
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= (unsigned char) data[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+std::uint64_t LevelCooker::settingsHash() {
+    std::vector<float> settings { PathBuilder::CURVE_TOLERANCE, PAGE_SIZE };
+    settings.insert(
+        settings.end(),
+        LevelReader::DECORATION_DETAIL_TOLERANCES.begin(),
+        LevelReader::DECORATION_DETAIL_TOLERANCES.end()
+    );
+
+    return hash(reinterpret_cast<const char*>(settings.data()), settings.size() * sizeof(float));
+}
+
+LevelCooker::Source LevelCooker::stat(const std::string &svgPath) {
+    std::error_code error;
+    Source source;
+
+    source.size = std::filesystem::file_size(svgPath, error);
+    if (error) {
+        throw std::runtime_error("could not find file: " + svgPath);
+    }
+
+    source.modified = std::filesystem::last_write_time(svgPath, error).time_since_epoch().count();
+    if (error) {
+        throw std::runtime_error("could not find file: " + svgPath);
+    }
+
+    return source;
+}
+
+std::vector<LevelPage> LevelCooker::split(const LevelData &level) {
+    struct Cell {
+        LevelData level;
+        sf::FloatRect bounds;
+        bool empty = true;
+    };
+
+    // Ordered so that pages are always laid out the same way for the same level
+    std::map<std::pair<int, int>, Cell> cells;
+
+    // Shapes go in the page their centre is in, but grow the page to fit all of them
+    auto cellFor = [&cells](const LevelShape &shape) -> LevelData& {
+        auto bounds = getBounds(shape);
+        auto key = std::make_pair(
+            (int) std::floor((bounds.left + bounds.width / 2.f) / PAGE_SIZE),
+            (int) std::floor((bounds.top + bounds.height / 2.f) / PAGE_SIZE)
+        );
+
+        auto &cell = cells[key];
+        cell.bounds = cell.empty ? bounds : merge(cell.bounds, bounds);
+        cell.empty = false;
+
+        return cell.level;
+    };
+
+    for (const auto &wall : level.walls) {
+        cellFor(wall).walls.push_back(wall);
+    }
+
+    for (const auto &zone : level.deathZones) {
+        cellFor(zone.shape).deathZones.push_back(zone);
+    }
+
+    for (const auto &checkpoint : level.checkpoints) {
+        cellFor(checkpoint.shape).checkpoints.push_back(checkpoint);
+    }
+
+    for (const auto &decoration : level.decorations) {
+        cellFor(decoration).decorations.push_back(decoration);
+    }
+
+    std::vector<LevelPage> pages;
+    pages.reserve(cells.size());
+
+    for (auto &[key, cell] : cells) {
+        cell.level.spawn = level.spawn;
+        pages.push_back(LevelPage { cell.bounds, std::move(cell.level) });
+    }
+
+    return pages;
+}
+
+std::vector<char> LevelCooker::serialise(const LevelData &level, const Source &source) {
+    auto pages = split(level);
+
+    std::vector<std::vector<char>> bodies(pages.size());
+    for (std::size_t i = 0; i < pages.size(); i++) {
+        Writer(bodies[i]).scenery(pages[i].level);
+    }
+
+    std::vector<char> out;
+    Writer writer(out);
+
+    out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    writer.value(VERSION);
+    writer.value(settingsHash());
+    writer.value(source.size);
+    writer.value(source.modified);
+    writer.value(source.hash);
+
+    writer.value(level.spawn);
+
+    // The pages follow the table straight after each other
+    writer.value((std::uint32_t) pages.size());
+    std::uint64_t offset = out.size() + pages.size() * (sizeof(sf::FloatRect) + 2 * sizeof(std::uint64_t));
+
+    for (std::size_t i = 0; i < pages.size(); i++) {
+        writer.value(pages[i].bounds);
+        writer.value(offset);
+        writer.value((std::uint64_t) bodies[i].size());
+
+        offset += bodies[i].size();
+    }
+
+    for (const auto &body : bodies) {
+        out.insert(out.end(), body.begin(), body.end());
+    }
+
+    return out;
+}
+
+std::optional<CookedLevel> LevelCooker::index(std::vector<char> data, const Source &source) {
+    return readIndex(CookedLevel(std::move(data)), source);
+}
+
+std::optional<LevelData> LevelCooker::deserialise(const char *data, std::size_t size, const Source &source) {
+    auto level = index(std::vector<char>(data, data + size), source);
+    if (!level) {
+        return std::optional<LevelData>();
+    }
+
+    return level->readAll();
+}
+
+const std::shared_ptr<spdlog::logger> &LevelCooker::logger() {
+    static const auto log = Logging::get(Logging::MAP);
+
+    return log;
+}
+
+std::optional<CookedLevel> LevelCooker::readIndex(CookedLevel level, const Source &source) {
+    Reader reader(level.data(), level.size());
+
+    if (level.size() < sizeof(MAGIC) || std::memcmp(level.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        return std::optional<CookedLevel>();
+    }
+
+    for (std::size_t i = 0; i < sizeof(MAGIC); i++) {
+        reader.value<char>();
+    }
+
+    if (reader.value<std::uint32_t>() != VERSION || reader.value<std::uint64_t>() != settingsHash()) {
+        return std::optional<CookedLevel>();
+    }
+
+    Source cooked;
+    cooked.size = reader.value<std::uint64_t>();
+    cooked.modified = reader.value<std::int64_t>();
+    cooked.hash = reader.value<std::uint64_t>();
+
+    bool untouched = cooked.size == source.size && cooked.modified == source.modified;
+    if (!untouched && cooked.hash != source.hash) {
+        return std::optional<CookedLevel>();
+    }
+
+    level.spawn_ = reader.value<sf::Vector2f>();
+
+    auto pageCount = reader.value<std::uint32_t>();
+    for (std::uint32_t i = 0; i < pageCount; i++) {
+        CookedPage page;
+        page.bounds = reader.value<sf::FloatRect>();
+        page.offset = reader.value<std::uint64_t>();
+        page.size = reader.value<std::uint64_t>();
+
+        level.pages_.push_back(page);
+    }
+
+    // Pages are only decoded when they are needed, so check now that they are all there
+    std::uint64_t expected = reader.position();
+    for (const auto &page : level.pages_) {
+        if (page.offset != expected) {
+            throw std::runtime_error("Cooked page is out of place");
+        }
+
+        if (page.size > level.size() - expected) {
+            throw std::runtime_error("Cooked level is truncated");
+        }
+
+        expected += page.size;
+    }
+
+    if (expected != level.size()) {
+        throw std::runtime_error("Cooked level has trailing data");
+    }
+
+    return level;
+}
+
+std::vector<char> LevelCooker::recook(const std::string &svgPath, Source &source, ThreadPool *pool, bool &changed) {
+    auto svg = readFile(svgPath);
+    source.hash = hash(svg.data(), svg.size());
+
+    // A checkout can touch the svg without changing it, the cook is still good but is written
+    // again with the new time so the next load can skip reading the svg. The old cook is
+    // decoded and unmapped before anything is written over it.
+    auto cookedFile = cookedPath(svgPath);
+    std::optional<LevelData> level;
+    if (auto cooked = loadCooked(cookedFile, source)) {
+        SPDLOG_LOGGER_INFO(logger(), "Loaded cooked level {}", cookedFile);
+        level = cooked->readAll();
+    }
+
+    changed = !level;
+    if (changed) {
+        level = LevelReader::readBuffer(svg.data(), svg.size(), svgPath, pool);
+    }
+
+    return serialise(level.value(), source);
+}
+
+std::vector<char> LevelCooker::readFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+    if (!file) {
+        throw std::runtime_error("could not find file: " + path);
+    }
+
+    std::vector<char> contents((std::size_t) file.tellg());
+    file.seekg(0);
+    file.read(contents.data(), (std::streamsize) contents.size());
+
+    return contents;
+}
+
+std::optional<CookedLevel> LevelCooker::loadCooked(const std::string &path, const Source &source) {
+    if (!std::filesystem::exists(path)) {
+        return std::optional<CookedLevel>();
+    }
+
+    // A damaged cook is treated the same as a stale one and rebuilt
+    try {
+        return readIndex(CookedLevel(std::make_unique<MappedFile>(path)), source);
+    } catch (const std::runtime_error& error) {
+        SPDLOG_LOGGER_WARN(logger(), "Ignoring cooked level {}: {}", path, error.what());
+        return std::optional<CookedLevel>();
+    }
+}
+
+void LevelCooker::writeCooked(const std::string &path, const std::vector<char> &data) {
+    // Write to a temporary file first so a reader never sees a half written cook
+    auto temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("could not write file: " + temporary);
+        }
+
+        file.write(data.data(), (std::streamsize) data.size());
+        if (!file) {
+            throw std::runtime_error("could not write file: " + temporary);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        throw std::runtime_error("could not write file: " + path + ": " + error.message());
+    }
+
+    SPDLOG_LOGGER_INFO(logger(), "Cooked {} ({} bytes)", path, data.size());
+}
@@ -0,0 +1,180 @@
+//
+// Created by derek on 14/11/20.
+//
+
+#ifndef SLINGER_LEVEL_COOKER_H
+#define SLINGER_LEVEL_COOKER_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include "level_data.h"
+#include "logging.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+
+/**
+ * A square of a level, grown to fit every shape whose centre is inside it
+ */
+struct LevelPage {
+    sf::FloatRect bounds;
+    LevelData level;
+};
+
+/**
+ * Where a page is in a cooked level
+ */
+struct CookedPage {
+    sf::FloatRect bounds;
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+};
+
+/**
+ * A cooked level with only its page table read. The cook stays mapped and each page is decoded
+ * straight out of it when it is needed, so a level never has to be in memory all at once.
+ */
+class CookedLevel {
+    friend class LevelCooker;
+
+    // Mapped when the level was cooked to a file, held here when it was cooked in memory
+    std::unique_ptr<MappedFile> file_;
+    std::vector<char> buffer_;
+
+    sf::Vector2f spawn_;
+    std::vector<CookedPage> pages_;
+
+public:
+    CookedLevel(CookedLevel&&) = default;
+    CookedLevel& operator=(CookedLevel&&) = default;
+
+    [[nodiscard]] const sf::Vector2f& getSpawn() const;
+    [[nodiscard]] const std::vector<CookedPage>& getPages() const;
+
+    /**
+     * Decode a page, only the page's own bytes are read so any number can be decoded at once
+     */
+    [[nodiscard]] LevelData readPage(const CookedPage& page) const;
+
+    /**
+     * Decode every page into a single level
+     */
+    [[nodiscard]] LevelData readAll() const;
+
+private:
+    explicit CookedLevel(std::unique_ptr<MappedFile> file);
+    explicit CookedLevel(std::vector<char> buffer);
+
+    [[nodiscard]] const char* data() const;
+    [[nodiscard]] std::size_t size() const;
+};
+
+/**
+ * Converts level svgs into a binary format that can be loaded without any parsing. Cooked
+ * levels are stored next to the svg and tagged with its size, modification time and a hash of
+ * its contents, so editing the svg makes the cooked copy stale and it is rebuilt on the next
+ * load. While the size and time still match the svg isn't read at all.
+ *
+ * The level is cooked already split into pages, with a table of where each one is, so a pager
+ * can decode the pages near the player without touching the rest.
+ */
+class LevelCooker {
+public:
+    /**
+     * The svg a level was cooked from
+     */
+    struct Source {
+        std::uint64_t size = 0;
+        std::int64_t modified = 0;
+
+        // Left at 0 until the svg has been read
+        std::uint64_t hash = 0;
+    };
+
+    static const char MAGIC[4];
+
+    // Bump this whenever the format or the way levels are read changes. The tolerances levels
+    // are read with are part of the key on their own, so changing one doesn't need a bump.
+    static const std::uint32_t VERSION;
+
+    static const std::string COOKED_EXTENSION;
+
+    // Pages are squares of this size, grown to fit the shapes whose centres are inside them
+    static const float PAGE_SIZE;
+
+    /**
+     * Open the cooked copy of a level, cooking it first if it is missing or stale. The level is
+     * kept in memory instead if the cook can't be written.
+     * @param pool used to read the svg in parallel if it has to be read
+     */
+    static CookedLevel open(const std::string& svgPath, ThreadPool* pool = nullptr);
+
+    /**
+     * Load the whole of a level, going through its cooked copy the same way as open
+     */
+    static LevelData load(const std::string& svgPath, ThreadPool* pool = nullptr);
+
+    /**
+     * Cook a level if its cooked copy is missing or stale
+     * @return whether the level was cooked
+     */
+    static bool cook(const std::string& svgPath, ThreadPool* pool = nullptr);
+
+    static std::string cookedPath(const std::string& svgPath);
+    static std::uint64_t hash(const char* data, std::size_t size);
+
+    /**
+     * A hash of every setting that changes the geometry read from an svg
+     */
+    static std::uint64_t settingsHash();
+
+    /**
+     * The size and modification time of an svg, without reading it
+     */
+    static Source stat(const std::string& svgPath);
+
+    /**
+     * Split the scenery of a level into pages, always the same way for the same level
+     */
+    static std::vector<LevelPage> split(const LevelData& level);
+
+    static std::vector<char> serialise(const LevelData& level, const Source& source);
+
+    /**
+     * Read the page table of cooked level data, returns nothing if the data is from another
+     * version, was read with other settings, or is from another source. A source matches if
+     * either its hash or both its size and modification time are the same.
+     */
+    static std::optional<CookedLevel> index(std::vector<char> data, const Source& source);
+
+    /**
+     * Read a whole cooked level, returns nothing under the same conditions as index
+     */
+    static std::optional<LevelData> deserialise(const char* data, std::size_t size, const Source& source);
+
+private:
+    /**
+     * The map logger, asked for once since there's no instance to keep it in
+     */
+    static const std::shared_ptr<spdlog::logger>& logger();
+
+    static std::optional<CookedLevel> readIndex(CookedLevel level, const Source& source);
+
+    /**
+     * Cook a level whose svg has been touched, reusing the old cook if only its time changed
+     * @param changed set to whether the svg had to be read again
+     */
+    static std::vector<char> recook(const std::string& svgPath, Source& source, ThreadPool* pool, bool& changed);
+
+    static std::vector<char> readFile(const std::string& path);
+    static std::optional<CookedLevel> loadCooked(const std::string& path, const Source& source);
+    static void writeCooked(const std::string& path, const std::vector<char>& data);
+};
+
+
+#endif //SLINGER_LEVEL_COOKER_H
@@ -0,0 +1,67 @@
+//
+// Created by derek on 14/11/20.
+//
+
+#ifndef SLINGER_LEVEL_DATA_H
+#define SLINGER_LEVEL_DATA_H
+
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include "mesh_shape.h"
+#include "triangulator.h"
+
+/**
+ * A rectangle by its centre, in world coordinates
+ */
+struct Dimensions {
+    float x = 0;
+    float y = 0;
+    float width = 0;
+    float height = 0;
+};
+
+/**
+ * A flattened polygon, triangulated ahead of time if it is drawn
+ */
+struct LevelPolygon {
+    std::vector<sf::Vector2f> outline;
+    Mesh mesh;
+    std::vector<DetailMesh> detailLevels;
+};
+
+struct LevelShape {
+    enum class Type : std::uint8_t {
+        RECT,
+        POLYGON
+    };
+
+    Type type = Type::RECT;
+    Dimensions rect;
+    LevelPolygon polygon;
+};
+
+struct LevelDeathZone {
+    LevelShape shape;
+    bool spikes = false;
+};
+
+struct LevelCheckpoint {
+    LevelShape shape;
+    bool finish = false;
+};
+
+/**
+ * Everything needed to build a level, with all of the parsing and geometry work already done
+ */
+struct LevelData {
+    sf::Vector2f spawn;
+    std::vector<LevelShape> walls;
+    std::vector<LevelDeathZone> deathZones;
+    std::vector<LevelCheckpoint> checkpoints;
+    std::vector<LevelShape> decorations;
+};
+
+
+#endif //SLINGER_LEVEL_DATA_H
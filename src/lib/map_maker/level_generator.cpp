@@ -0,0 +1,195 @@
+//
+// Created by derek on 21/11/20.
+//
+
+#include "level_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+const float LevelGenerator::CELL_SIZE = 8.f;
+const std::size_t LevelGenerator::MAX_PATH_COMPLEXITY = 100;
+
+const float LevelGenerator::DEATH_ZONE_SHARE = 0.1f;
+const float LevelGenerator::CHECKPOINT_SHARE = 0.05f;
+const float LevelGenerator::DECORATION_SHARE = 0.15f;
+
+namespace {
+    const float PI = 3.141592654f;
+
+    enum class Layer {
+        WALLS,
+        DEATH_ZONES,
+        CHECKPOINTS,
+        DECORATIONS
+    };
+
+    const char* layerLabel(Layer layer) {
+        switch (layer) {
+            case Layer::WALLS:
+                return "walls";
+            case Layer::DEATH_ZONES:
+                return "death_zones";
+            case Layer::CHECKPOINTS:
+                return "checkpoints";
+            default:
+                return "decorations";
+        }
+    }
+}
+
+LevelGenerator &LevelGenerator::setElements(std::size_t elements) {
+    elements_ = elements;
+    return *this;
+}
+
+LevelGenerator &LevelGenerator::setPathComplexity(std::size_t points) {
+    pathComplexity_ = std::clamp(points, (std::size_t) 3, MAX_PATH_COMPLEXITY);
+    return *this;
+}
+
+LevelGenerator &LevelGenerator::setConcavity(float concavity) {
+    concavity_ = std::clamp(concavity, 0.f, 0.9f);
+    return *this;
+}
+
+LevelGenerator &LevelGenerator::setDensity(float density) {
+    density_ = std::clamp(density, 0.01f, 1.f);
+    return *this;
+}
+
+LevelGenerator &LevelGenerator::setPolygonShare(float share) {
+    polygonShare_ = std::clamp(share, 0.f, 1.f);
+    return *this;
+}
+
+LevelGenerator &LevelGenerator::setSeed(std::uint32_t seed) {
+    seed_ = seed;
+    return *this;
+}
+
+void LevelGenerator::write(std::ostream &out) const {
+    std::mt19937 random(seed_);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+    // Lay the level out as a square grid with enough cells for every shape plus the player
+    auto cellCount = std::max(elements_ + 1, (std::size_t) std::ceil((float) elements_ / density_));
+    auto columns = (std::size_t) std::ceil(std::sqrt((float) cellCount));
+
+    std::vector<std::size_t> cells(cellCount);
+    std::iota(cells.begin(), cells.end(), 0);
+    std::shuffle(cells.begin(), cells.end(), random);
+
+    auto centreOf = [columns](std::size_t cell) {
+        return sf::Vector2f(
+            ((float) (cell % columns) + 0.5f) * CELL_SIZE,
+            ((float) (cell / columns) + 0.5f) * CELL_SIZE
+        );
+    };
+
+    auto deathZones = (std::size_t) ((float) elements_ * DEATH_ZONE_SHARE);
+    auto checkpoints = (std::size_t) ((float) elements_ * CHECKPOINT_SHARE);
+    auto decorations = (std::size_t) ((float) elements_ * DECORATION_SHARE);
+    auto walls = elements_ - deathZones - checkpoints - decorations;
+
+    auto size = (float) columns * CELL_SIZE;
+    out << std::fixed;
+    out.precision(3);
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
+        << "<svg xmlns=\"http://www.w3.org/2000/svg\" "
+        << "xmlns:inkscape=\"http://www.inkscape.org/namespaces/inkscape\" "
+        << "width=\"" << size << "\" height=\"" << size << "\" "
+        << "viewBox=\"0 0 " << size << " " << size << "\">\n";
+
+    std::size_t next = 0;
+    auto writeLayer = [&](Layer layer, std::size_t count) {
+        out << "  <g inkscape:label=\"" << layerLabel(layer) << "\" inkscape:groupmode=\"layer\">\n";
+
+        for (std::size_t i = 0; i < count; i++) {
+            auto centre = centreOf(cells[next++]);
+
+            // Only finish lines can be polygons, and a level only needs one of those
+            if (layer == Layer::CHECKPOINTS) {
+                writeRect(out, centre, sf::Vector2f(CELL_SIZE / 2.f, CELL_SIZE / 2.f), i + 1 == count ? "finish" : nullptr);
+                continue;
+            }
+
+            if (unit(random) < polygonShare_) {
+                writePath(out, centre, random);
+                continue;
+            }
+
+            sf::Vector2f rectSize(
+                CELL_SIZE * (0.25f + unit(random) * 0.5f),
+                CELL_SIZE * (0.25f + unit(random) * 0.5f)
+            );
+            writeRect(out, centre, rectSize, layer == Layer::DEATH_ZONES && unit(random) < 0.5f ? "spikes" : nullptr);
+        }
+
+        out << "  </g>\n";
+    };
+
+    writeLayer(Layer::WALLS, walls);
+    writeLayer(Layer::DEATH_ZONES, deathZones);
+    writeLayer(Layer::CHECKPOINTS, checkpoints);
+    writeLayer(Layer::DECORATIONS, decorations);
+
+    out << "  <g inkscape:label=\"objects\" inkscape:groupmode=\"layer\">\n";
+    auto spawn = centreOf(cells[next]);
+    out << "    <rect id=\"player\" x=\"" << spawn.x - 1.f << "\" y=\"" << spawn.y - 2.f
+        << "\" width=\"2\" height=\"4\" />\n";
+    out << "  </g>\n";
+
+    out << "</svg>\n";
+}
+
+void LevelGenerator::write(const std::string &path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Could not open " + path + " to write a level to");
+    }
+
+    write(out);
+}
+
+std::string LevelGenerator::generate() const {
+    std::ostringstream out;
+    write(out);
+
+    return out.str();
+}
+
+void LevelGenerator::writeRect(std::ostream &out, const sf::Vector2f &centre, const sf::Vector2f &size, const char *label) {
+    out << "    <rect ";
+    if (label) {
+        out << "inkscape:label=\"" << label << "\" ";
+    }
+
+    out << "x=\"" << centre.x - size.x / 2.f << "\" y=\"" << centre.y - size.y / 2.f
+        << "\" width=\"" << size.x << "\" height=\"" << size.y << "\" />\n";
+}
+
+void LevelGenerator::writePath(std::ostream &out, const sf::Vector2f &centre, std::mt19937 &random) const {
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    const float radius = CELL_SIZE * 0.4f;
+
+    // A star around the centre, alternate points are pulled in to make it concave
+    out << "    <path d=\"M";
+    for (std::size_t i = 0; i < pathComplexity_; i++) {
+        float angle = 2.f * PI * (float) i / (float) pathComplexity_;
+        float distance = radius;
+
+        if (i % 2 == 1) {
+            distance *= 1.f - concavity_ * unit(random);
+        }
+
+        out << (i == 0 ? " " : " L ") << centre.x + std::cos(angle) * distance << "," << centre.y + std::sin(angle) * distance;
+    }
+
+    out << " Z\" />\n";
+}
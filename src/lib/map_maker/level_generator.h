@@ -0,0 +1,73 @@
+//
+// Created by derek on 21/11/20.
+//
+
+#ifndef SLINGER_LEVEL_GENERATOR_H
+#define SLINGER_LEVEL_GENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+
+#include <SFML/System/Vector2.hpp>
+
+/**
+ * Writes synthetic levels in the same layered svg format as the hand made ones, for measuring
+ * how loading and playing scale with the amount of content. The same settings always make the
+ * same level.
+ */
+class LevelGenerator {
+    std::size_t elements_ = 1000;
+    std::size_t pathComplexity_ = 8;
+    float concavity_ = 0.3f;
+    float density_ = 0.5f;
+    float polygonShare_ = 0.5f;
+    std::uint32_t seed_ = 1;
+
+public:
+    static const float CELL_SIZE;
+    static const std::size_t MAX_PATH_COMPLEXITY;
+
+    static const float DEATH_ZONE_SHARE;
+    static const float CHECKPOINT_SHARE;
+    static const float DECORATION_SHARE;
+
+    /**
+     * How many shapes to make across all layers, the player isn't counted
+     */
+    LevelGenerator& setElements(std::size_t elements);
+
+    /**
+     * How many points each polygon has, up to the most physics supports
+     */
+    LevelGenerator& setPathComplexity(std::size_t points);
+
+    /**
+     * How far polygon points are pulled in towards their centre, 0 is always convex
+     */
+    LevelGenerator& setConcavity(float concavity);
+
+    /**
+     * The fraction of the level's grid cells that hold a shape, the level grows to fit
+     */
+    LevelGenerator& setDensity(float density);
+
+    /**
+     * The fraction of walls, death zones and decorations that are paths rather than rects
+     */
+    LevelGenerator& setPolygonShare(float share);
+
+    LevelGenerator& setSeed(std::uint32_t seed);
+
+    void write(std::ostream& out) const;
+    void write(const std::string& path) const;
+    [[nodiscard]] std::string generate() const;
+
+private:
+    static void writeRect(std::ostream& out, const sf::Vector2f& centre, const sf::Vector2f& size, const char* label);
+    void writePath(std::ostream& out, const sf::Vector2f& centre, std::mt19937& random) const;
+};
+
+
+#endif //SLINGER_LEVEL_GENERATOR_H
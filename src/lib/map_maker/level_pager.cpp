@@ -0,0 +1,128 @@
+//
+// Created by derek on 18/11/20.
+//
+
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+
+#include "level_pager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <spdlog/spdlog.h>
+
+const float LevelPager::ACTIVATE_DISTANCE = 48.f;
+const float LevelPager::DEACTIVATE_DISTANCE = 96.f;
+const float LevelPager::REQUIRED_DISTANCE = 16.f;
+
+LevelPager::LevelPager(entt::registry &registry, Physics &physics, MapShapeBuilder &builder):
+    scenery_(registry, physics, builder)
+{
+
+}
+
+LevelPager::~LevelPager() {
+    // Workers still decoding pages refer to them, so wait for them before the pages go
+    for (auto &page : pages_) {
+        if (page.loading.valid()) {
+            page.loading.wait();
+        }
+    }
+}
+
+void LevelPager::load(CookedLevel level) {
+    clear();
+
+    level_ = std::make_unique<CookedLevel>(std::move(level));
+
+    pages_.reserve(level_->getPages().size());
+    for (const auto &cooked : level_->getPages()) {
+        Page page;
+        page.cooked = cooked;
+
+        pages_.push_back(std::move(page));
+    }
+
+    SPDLOG_LOGGER_INFO(log_, "Paging level with {} pages", pages_.size());
+}
+
+void LevelPager::load(const LevelData &level) {
+    load(LevelCooker::index(LevelCooker::serialise(level, LevelCooker::Source {}), LevelCooker::Source {}).value());
+}
+
+void LevelPager::update(const sf::Vector2f &focus, ThreadPool *pool) {
+    for (auto &page : pages_) {
+        auto pageDistance = distance(page.cooked.bounds, focus);
+
+        if (page.active) {
+            if (pageDistance > DEACTIVATE_DISTANCE && !scenery_.isHeld(page.entities)) {
+                deactivate(page);
+            }
+
+            continue;
+        }
+
+        if (!page.loading.valid()) {
+            if (pageDistance > ACTIVATE_DISTANCE) {
+                continue;
+            }
+
+            auto decode = [&level = *level_, cooked = page.cooked]() {
+                return level.readPage(cooked);
+            };
+
+            page.loading = pool ? pool->submit(decode) : std::async(std::launch::deferred, decode);
+        }
+
+        // Deferred pages are decoded by get, the rest are only waited for if they are needed now
+        auto status = page.loading.wait_for(std::chrono::seconds(0));
+        if (status != std::future_status::timeout || pageDistance < REQUIRED_DISTANCE) {
+            commit(page, page.loading.get());
+        }
+    }
+}
+
+std::size_t LevelPager::pageCount() const {
+    return pages_.size();
+}
+
+std::size_t LevelPager::activePageCount() const {
+    return std::count_if(pages_.begin(), pages_.end(), [](const Page &page) { return page.active; });
+}
+
+void LevelPager::commit(Page &page, const LevelData &level) {
+    page.entities = scenery_.add(level);
+    page.active = true;
+
+    SPDLOG_LOGGER_DEBUG(log_, "Activated page with {} entities", page.entities.size());
+}
+
+void LevelPager::deactivate(Page &page) {
+    SPDLOG_LOGGER_DEBUG(log_, "Deactivated page with {} entities", page.entities.size());
+
+    scenery_.remove(page.entities);
+    page.active = false;
+}
+
+void LevelPager::clear() {
+    for (auto &page : pages_) {
+        if (page.loading.valid()) {
+            page.loading.wait();
+        }
+
+        if (page.active) {
+            deactivate(page);
+        }
+    }
+
+    pages_.clear();
+    level_.reset();
+}
+
+float LevelPager::distance(const sf::FloatRect &bounds, const sf::Vector2f &point) {
+    auto dx = std::max({ bounds.left - point.x, 0.f, point.x - (bounds.left + bounds.width) });
+    auto dy = std::max({ bounds.top - point.y, 0.f, point.y - (bounds.top + bounds.height) });
+
+    return std::sqrt(dx * dx + dy * dy);
+}
@@ -0,0 +1,91 @@
+//
+// Created by derek on 18/11/20.
+//
+
+#ifndef SLINGER_LEVEL_PAGER_H
+#define SLINGER_LEVEL_PAGER_H
+
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <entt/entity/registry.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include "level_cooker.h"
+#include "level_data.h"
+#include "logging.h"
+#include "physics.h"
+#include "thread_pool.h"
+#include "scenery_tracker.h"
+
+/**
+ * Only keeps the pages of a cooked level near the followed entity in the world. Pages are
+ * decoded on a worker thread as they come into range and added to the world once they are
+ * ready. Pages are kept until they are well out of range so moving back and forth along a
+ * boundary doesn't keep swapping them in and out.
+ *
+ * Inactive pages take up nothing but their place in the page table, they are decoded straight
+ * out of the mapped cook when they are needed again. Meshes of removed pages are released
+ * from the MeshCache with their drawables, so memory follows the pages near the player rather
+ * than the size of the level.
+ */
+class LevelPager {
+    struct Page {
+        // Where the page is in the cooked level
+        CookedPage cooked;
+        std::future<LevelData> loading;
+        std::vector<entt::entity> entities;
+        bool active = false;
+    };
+
+    SceneryTracker scenery_;
+
+    // Stays mapped while the level is loaded, pages still decoding read from it
+    std::unique_ptr<CookedLevel> level_;
+    std::vector<Page> pages_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::MAP);
+
+public:
+    // Pages closer than this are loaded in the background
+    static const float ACTIVATE_DISTANCE;
+
+    // Pages further than this are removed, this is larger than the activate distance
+    static const float DEACTIVATE_DISTANCE;
+
+    // Pages closer than this have to exist, so are loaded straight away if they aren't ready
+    static const float REQUIRED_DISTANCE;
+
+    LevelPager(entt::registry& registry, Physics& physics, MapShapeBuilder& builder);
+    ~LevelPager();
+
+    /**
+     * Page a cooked level, removing any pages already loaded
+     */
+    void load(CookedLevel level);
+
+    /**
+     * Page a level that hasn't been cooked to a file, cooking it in memory
+     */
+    void load(const LevelData& level);
+
+    /**
+     * Start loading pages near the point, add any that have finished loading and remove any
+     * that are far enough away
+     * @param pool decodes pages in the background, without one they are decoded when needed
+     */
+    void update(const sf::Vector2f& focus, ThreadPool* pool = nullptr);
+
+    [[nodiscard]] std::size_t pageCount() const;
+    [[nodiscard]] std::size_t activePageCount() const;
+
+private:
+    void commit(Page& page, const LevelData& level);
+    void deactivate(Page& page);
+    void clear();
+
+    static float distance(const sf::FloatRect& bounds, const sf::Vector2f& point);
+};
+
+
+#endif //SLINGER_LEVEL_PAGER_H
@@ -0,0 +1,274 @@
+//
+// Created by derek on 14/11/20.
+//
+
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+
+#include "level_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+
+#include "logging.h"
+#include "path_builder.h"
+#include "simplifier.h"
+#include "tracer.h"
+
+const std::vector<float> LevelReader::DECORATION_DETAIL_TOLERANCES = { 0.05f, 0.2f, 0.8f };
+
+LevelData LevelReader::readFile(const std::string &path, ThreadPool *pool) {
+    pugi::xml_document doc;
+    pugi::xml_parse_result result = doc.load_file(path.c_str());
+
+    if (!result) {
+        throw std::runtime_error("could not find file: " + path);
+    }
+
+    return read(doc, path, pool);
+}
+
+LevelData LevelReader::readBuffer(const char *data, std::size_t size, const std::string &name, ThreadPool *pool) {
+    pugi::xml_document doc;
+    pugi::xml_parse_result result = doc.load_buffer(data, size);
+
+    if (!result) {
+        throw std::runtime_error("could not parse level: " + name);
+    }
+
+    return read(doc, name, pool);
+}
+
+LevelData LevelReader::read(const pugi::xml_document &doc, const std::string &name, ThreadPool *pool) {
+    SLINGER_TRACE("LevelReader::read");
+    Context context { name };
+
+    auto svg = doc.child("svg");
+    if (!svg) {
+        throw std::runtime_error("Could not find svg element in " + name);
+    }
+
+    // Visit each layer once, handing it to whatever reads that kind of layer
+    const auto &handlers = layerHandlers();
+    for (const auto &layer : svg.children("g")) {
+        auto label = layer.attribute("inkscape:label").as_string();
+        auto handler = handlers.find(label);
+
+        if (handler == handlers.end()) {
+            SPDLOG_LOGGER_WARN(logger(), "Ignoring unknown layer '{}' in {}", label, name);
+            continue;
+        }
+
+        handler->second(layer, context);
+    }
+
+    if (!context.hasSpawn) {
+        throw std::runtime_error("Could not find player in svg " + name);
+    }
+
+    // The document is only read from here on so every shape can be read at once
+    SLINGER_TRACE("LevelReader::readShapes");
+    if (pool) {
+        pool->parallelFor(context.tasks.size(), [&context](std::size_t i) { context.tasks[i](); });
+    } else {
+        for (auto &task : context.tasks) {
+            task();
+        }
+    }
+
+    const auto &level = context.level;
+    SPDLOG_LOGGER_DEBUG(
+        logger(),
+        "Read {} walls, {} death zones, {} checkpoints and {} decorations from {}",
+        level.walls.size(),
+        level.deathZones.size(),
+        level.checkpoints.size(),
+        level.decorations.size(),
+        name
+    );
+
+    return std::move(context.level);
+}
+
+void LevelReader::setLayerHandler(const std::string &label, LevelReader::LayerHandler handler) {
+    layerHandlers()[label] = std::move(handler);
+}
+
+void LevelReader::removeLayerHandler(const std::string &label) {
+    layerHandlers().erase(label);
+}
+
+LevelReader::ScopedLayerHandler::ScopedLayerHandler(std::string label, LayerHandler handler): label_(std::move(label)) {
+    auto &handlers = layerHandlers();
+    auto existing = handlers.find(label_);
+
+    if (existing != handlers.end()) {
+        previous_ = std::move(existing->second);
+    }
+
+    setLayerHandler(label_, std::move(handler));
+}
+
+LevelReader::ScopedLayerHandler::~ScopedLayerHandler() {
+    if (previous_) {
+        setLayerHandler(label_, std::move(*previous_));
+    } else {
+        removeLayerHandler(label_);
+    }
+}
+
+const std::shared_ptr<spdlog::logger> &LevelReader::logger() {
+    static const auto log = Logging::get(Logging::MAP);
+
+    return log;
+}
+
+std::unordered_map<std::string, LevelReader::LayerHandler> &LevelReader::layerHandlers() {
+    static std::unordered_map<std::string, LayerHandler> handlers {
+        { "walls", eachChild(&LevelData::walls, readWall) },
+        { "death_zones", eachChild(&LevelData::deathZones, readDeathZone) },
+        { "checkpoints", eachChild(&LevelData::checkpoints, readCheckpoint) },
+        { "decorations", eachChild(&LevelData::decorations, readDecoration) },
+        { "objects", readObjects },
+    };
+
+    return handlers;
+}
+
+template <class T, class Read>
+LevelReader::LayerHandler LevelReader::eachChild(std::vector<T> LevelData::* list, Read read) {
+    return [list, read](const pugi::xml_node &layer, Context &context) {
+        for (const auto &child : layer.children()) {
+            if (child.type() == pugi::node_element) {
+                context.queue(child, context.level.*list, read);
+            }
+        }
+    };
+}
+
+void LevelReader::readObjects(const pugi::xml_node &layer, Context &context) {
+    auto player = layer.find_child_by_attribute("rect", "id", "player");
+    if (!player) {
+        return;
+    }
+
+    auto dimensions = readDimensions(player);
+    context.level.spawn = sf::Vector2f(dimensions.x, dimensions.y);
+    context.hasSpawn = true;
+}
+
+Dimensions LevelReader::readDimensions(const pugi::xml_node &node) {
+    Dimensions dimensions;
+    dimensions.width = node.attribute("width").as_float();
+    dimensions.height = node.attribute("height").as_float();
+    dimensions.x = node.attribute("x").as_float();
+    dimensions.y = node.attribute("y").as_float() * -1.f;
+    dimensions.x += dimensions.width/2.f;
+    dimensions.y -= dimensions.height/2.f;
+
+    return dimensions;
+}
+
+LevelShape LevelReader::readWall(const pugi::xml_node &node) {
+    if (strcmp(node.name(), "rect") == 0) {
+        LevelShape shape;
+        shape.rect = readDimensions(node);
+
+        return shape;
+    }
+    else if (strcmp(node.name(), "path") == 0) {
+        return readPolygon(node, true);
+    } else {
+        throw std::runtime_error("Unsupported element type for wall");
+    }
+}
+
+LevelDeathZone LevelReader::readDeathZone(const pugi::xml_node &node) {
+    LevelDeathZone zone;
+
+    auto label = node.attribute("inkscape:label");
+    zone.spikes = strcmp(label.value(), "spikes") == 0;
+
+    if (strcmp(node.name(), "rect") == 0) {
+        zone.shape.rect = readDimensions(node);
+    } else if (strcmp(node.name(), "path") == 0) {
+        zone.shape = readPolygon(node, false);
+    } else {
+        throw std::runtime_error("Unsupported element type for death zone");
+    }
+
+    return zone;
+}
+
+LevelCheckpoint LevelReader::readCheckpoint(const pugi::xml_node &node) {
+    LevelCheckpoint checkpoint;
+
+    auto label = node.attribute("inkscape:label");
+    checkpoint.finish = strcmp(label.value(), "finish") == 0;
+
+    if (strcmp(node.name(), "rect") == 0) {
+        checkpoint.shape.rect = readDimensions(node);
+    } else {
+        if (!checkpoint.finish) {
+            throw std::runtime_error("Polyagonal checkpoints are only supported for finishing lines");
+        }
+
+        checkpoint.shape = readPolygon(node, false);
+    }
+
+    return checkpoint;
+}
+
+LevelShape LevelReader::readDecoration(const pugi::xml_node &node) {
+    if (strcmp(node.name(), "rect") == 0) {
+        LevelShape shape;
+        shape.rect = readDimensions(node);
+
+        return shape;
+    } else if (strcmp(node.name(), "path") == 0) {
+        auto contours = PathBuilder::buildContours(node.attribute("d").as_string());
+
+        LevelShape shape;
+        shape.type = LevelShape::Type::POLYGON;
+        shape.polygon.mesh = Triangulator::triangulate(contours);
+
+        // The largest contour can't lie inside another so it is always an outer one, any other
+        // islands are only part of the mesh
+        auto outline = std::max_element(contours.begin(), contours.end(), [](const auto &lhs, const auto &rhs) {
+            return std::abs(Triangulator::signedArea(lhs)) < std::abs(Triangulator::signedArea(rhs));
+        });
+
+        if (outline != contours.end()) {
+            shape.polygon.outline = *outline;
+        }
+
+        for (auto tolerance : DECORATION_DETAIL_TOLERANCES) {
+            std::vector<Triangulator::Contour> simplified;
+            for (const auto &contour : contours) {
+                simplified.push_back(Simplifier::simplify(contour, tolerance));
+            }
+
+            shape.polygon.detailLevels.push_back(DetailMesh { tolerance, Triangulator::triangulate(simplified) });
+        }
+
+        return shape;
+    } else {
+        throw std::runtime_error("Unsupported element type for death zone");
+    }
+}
+
+LevelShape LevelReader::readPolygon(const pugi::xml_node &node, bool triangulate) {
+    LevelShape shape;
+    shape.type = LevelShape::Type::POLYGON;
+    shape.polygon.outline = PathBuilder::build(node.attribute("d").as_string());
+
+    // Svg polygons are often concave and can't be drawn as a fan
+    if (triangulate) {
+        shape.polygon.mesh = Triangulator::triangulate(shape.polygon.outline);
+    }
+
+    return shape;
+}
@@ -0,0 +1,130 @@
+//
+// Created by derek on 14/11/20.
+//
+
+#ifndef SLINGER_LEVEL_READER_H
+#define SLINGER_LEVEL_READER_H
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pugixml.hpp>
+
+#include "level_data.h"
+#include "logging.h"
+#include "thread_pool.h"
+#include "tracer.h"
+
+/**
+ * Reads a level svg into level data, flattening and triangulating every shape. None of this
+ * touches the registry or the physics world, so given a thread pool the shapes are read in
+ * parallel.
+ */
+class LevelReader {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * A level part way through being read
+     */
+    struct Context {
+        const std::string& name;
+        LevelData level;
+
+        // Reading shapes is left until every layer has been visited so it can run in parallel
+        std::vector<Task> tasks;
+        bool hasSpawn = false;
+
+        /**
+         * Add a slot to the end of the output and queue a task that reads the node into it
+         */
+        template <class T, class Read>
+        void queue(const pugi::xml_node& node, std::vector<T>& out, Read read);
+    };
+
+    /**
+     * Reads a top level group of the svg into the level
+     */
+    using LayerHandler = std::function<void(const pugi::xml_node& layer, Context& context)>;
+
+    static const std::vector<float> DECORATION_DETAIL_TOLERANCES;
+
+    static LevelData readFile(const std::string& path, ThreadPool* pool = nullptr);
+
+    /**
+     * Read a level from svg data that is already in memory
+     * @param name used to describe the level in errors and logs
+     */
+    static LevelData readBuffer(const char* data, std::size_t size, const std::string& name, ThreadPool* pool = nullptr);
+
+    static LevelData read(const pugi::xml_document& doc, const std::string& name, ThreadPool* pool = nullptr);
+
+    /**
+     * Sets a layer handler for as long as it lives, then puts back whichever one it replaced
+     */
+    class ScopedLayerHandler {
+        std::string label_;
+        std::optional<LayerHandler> previous_;
+
+    public:
+        ScopedLayerHandler(std::string label, LayerHandler handler);
+        ~ScopedLayerHandler();
+
+        ScopedLayerHandler(const ScopedLayerHandler&) = delete;
+        ScopedLayerHandler& operator=(const ScopedLayerHandler&) = delete;
+    };
+
+    /**
+     * Handle every layer with the given inkscape label, replacing any existing handler. Handlers
+     * are shared by every read without a lock, so they can only be changed at startup before
+     * any level is read.
+     */
+    static void setLayerHandler(const std::string& label, LayerHandler handler);
+    static void removeLayerHandler(const std::string& label);
+
+    static Dimensions readDimensions(const pugi::xml_node& node);
+
+    /**
+     * Read a path as a single polygon
+     * @param triangulate whether the polygon will be drawn and so needs a mesh
+     */
+    static LevelShape readPolygon(const pugi::xml_node& node, bool triangulate);
+
+private:
+    /**
+     * The map logger, asked for once since there's no instance to keep it in
+     */
+    static const std::shared_ptr<spdlog::logger>& logger();
+
+    static std::unordered_map<std::string, LayerHandler>& layerHandlers();
+
+    /**
+     * Make a handler that reads every child of a layer into a list in the level
+     */
+    template <class T, class Read>
+    static LayerHandler eachChild(std::vector<T> LevelData::* list, Read read);
+
+    static void readObjects(const pugi::xml_node& layer, Context& context);
+    static LevelShape readWall(const pugi::xml_node& node);
+    static LevelDeathZone readDeathZone(const pugi::xml_node& node);
+    static LevelCheckpoint readCheckpoint(const pugi::xml_node& node);
+    static LevelShape readDecoration(const pugi::xml_node& node);
+};
+
+template <class T, class Read>
+void LevelReader::Context::queue(const pugi::xml_node &node, std::vector<T> &out, Read read) {
+    // Tasks hold an index rather than a pointer as the list can still grow
+    auto index = out.size();
+    out.emplace_back();
+
+    tasks.emplace_back([&out, node, read, index]() {
+        SLINGER_TRACE("LevelReader::readShape");
+        out[index] = read(node);
+    });
+}
+
+
+#endif //SLINGER_LEVEL_READER_H
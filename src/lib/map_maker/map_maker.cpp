@@ -1,108 +1,193 @@
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
 
 #include <iostream>
-#include <regex>
+#include <optional>
+#include <stdexcept>
 
 #include <spdlog/spdlog.h>
-#include <pugixml.hpp>
 
 #include "map_maker.h"
 #include "body_builder.h"
 #include "input_manager.h"
-#include "path_builder.h"
+#include "level_cooker.h"
+#include "tracer.h"
 
 const sf::Color MapShapeBuilder::WALL_COLOUR = sf::Color(50, 50, 50); // sf::Color(255, 100, 50);
 const sf::Color MapShapeBuilder::DECORATION_COLOUR = sf::Color(200, 200, 200);
 
+const std::string MapShapeBuilder::SPIKE_TEXTURE_PATH = "data/spike.png";
+const std::string MapShapeBuilder::WALL_TEXTURE = "wall";
+const std::string MapShapeBuilder::WHEEL_TEXTURE = "wheel";
+const std::string MapShapeBuilder::RUNNING_TEXTURE = "running";
+
+const float MapShapeBuilder::COLLISION_TOLERANCE = 0.02f;
+
 const int MapShapeBuilder::BASE_Z_INDEX = 0;
 const int MapShapeBuilder::WALL_Z_INDEX = 0;
 const int MapShapeBuilder::DECORATION_Z_INDEX = 1;
 const int MapShapeBuilder::PLAYER_BODY_Z_INDEX = 2;
 const int MapShapeBuilder::PLAYER_ARM_Z_INDEX = 3;
 
-Dimensions::Dimensions(const pugi::xml_node &node) {
-    width = node.attribute("width").as_float();
-    height = node.attribute("height").as_float();
-    x = node.attribute("x").as_float();
-    y = node.attribute("y").as_float() * -1.f;
-    x += width/2.f;
-    y -= height/2.f;
+MapMaker::MapMaker(
+    entt::registry &registry,
+    Physics &physics,
+    const sf::Texture* spikeTexture,
+    const TextureAtlas* atlas
+):
+    registry_(registry),
+    mapShapeBuilder_(MapShapeBuilder(registry, physics, spikeTexture, atlas)),
+    pager_(registry, physics, mapShapeBuilder_),
+    endless_(registry, physics, mapShapeBuilder_)
+{
+
 }
 
-MapMaker::MapMaker(entt::registry &registry, Physics &physics): mapShapeBuilder_(MapShapeBuilder(registry, physics))
+void MapMaker::make(const std::string& path, ThreadPool* pool)
 {
+    SLINGER_TRACE("MapMaker::make");
+    pool_ = pool;
+
+    // Only the page table is read here, pages are decoded from the cook as they are needed
+    sf::Vector2f spawn;
+    {
+        SLINGER_TRACE("LevelCooker::open");
+        auto level = LevelCooker::open(path, pool);
+        spawn = level.getSpawn();
+
+        SLINGER_TRACE("LevelPager::load");
+        pager_.load(std::move(level));
+    }
+
+    // Load the pages around the spawn before the player can fall through them
+    SLINGER_TRACE("MapMaker::makeSpawn");
+    mapShapeBuilder_.makePlayer(spawn);
+    pager_.update(spawn, pool_);
 
+    SPDLOG_LOGGER_INFO(log_, "Successfully loaded {} as the current level", path);
 }
 
-void MapMaker::make(const std::string& path)
-{
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(path.c_str());
+void MapMaker::makeEndless(std::uint32_t seed, ThreadPool* pool) {
+    pool_ = pool;
 
-    if (!result) {
-        throw std::runtime_error("could not find file: " + path);
-    }
+    endless_.start(seed);
+    mapShapeBuilder_.makePlayer(endless_.getSpawn());
+    endless_.update(endless_.getSpawn(), endless_.getSpawn(), pool_);
+}
 
-    auto walls = doc.select_nodes("/svg/g[@inkscape:label='walls']/*");
-    for (const auto& wall: walls) {
-        mapShapeBuilder_.makeWall(wall.node());
-    }
-    SPDLOG_DEBUG("Added {} walls from {}", walls.size(), path);
+void MapMaker::update() {
+    SLINGER_TRACE("MapMaker::update");
 
-    auto deathZones = doc.select_nodes("/svg/g[@inkscape:label='death_zones']/*");
-    SPDLOG_DEBUG("Added {} death zones from {}", deathZones.size(), path);
-    for (const auto& zone: deathZones) {
-        mapShapeBuilder_.makeDeathZone(zone.node());
-    }
+    std::optional<sf::Vector2f> focus;
+    sf::Vector2f respawn;
+    registry_.view<Follow, Position>().each([this, &focus, &respawn](const auto entity, const Follow &follow, const Position &position) {
+        focus = position.value;
 
-    auto checkPoints = doc.select_nodes("/svg/g[@inkscape:label='checkpoints']/*");
-    SPDLOG_DEBUG("Added {} checkpoints from {}", checkPoints.size(), path);
-    for (const auto& zone: checkPoints) {
-        mapShapeBuilder_.makeCheckpoint(zone.node());
-    }
+        auto *respawnable = registry_.try_get<Respawnable>(entity);
+        respawn = respawnable ? respawnable->lastCheckpointLoc : position.value;
+    });
 
-    auto decorations = doc.select_nodes("/svg/g[@inkscape:label='decorations']/*");
-    for (const auto& decoration: decorations) {
-        mapShapeBuilder_.makeDecoration(decoration.node());
+    // Paging creates and destroys entities, so it can't happen while iterating over them
+    if (!focus) {
+        return;
     }
 
-    auto playerNode = doc.select_node("/svg/g[@inkscape:label='objects']/rect[@id='player']");
-    if (!playerNode) {
-        throw std::runtime_error("Could not find player in svg " + path);
+    if (endless_.isRunning()) {
+        endless_.update(focus.value(), respawn, pool_);
+    } else {
+        pager_.update(focus.value(), pool_);
     }
+}
 
-    mapShapeBuilder_.makePlayer(playerNode.node());
+void MapMaker::build(const LevelData &level) {
+    mapShapeBuilder_.makeScenery(level);
+    mapShapeBuilder_.makePlayer(level.spawn);
+}
 
-    SPDLOG_INFO("Successfully loaded {} as the current level", path);
+void MapMaker::setCollisionTolerance(float tolerance) {
+    mapShapeBuilder_.setCollisionTolerance(tolerance);
 }
 
-void MapShapeBuilder::makeWall(const pugi::xml_node &node) {
-    if (strcmp(node.name(), "rect") == 0) {
-        makeRect(node);
-    }
-    else if (strcmp(node.name(), "path") == 0) {
-        makePolygon(node);
+void MapShapeBuilder::makeWall(const LevelShape &wall) {
+    if (wall.type == LevelShape::Type::RECT) {
+        makeRect(wall.rect);
     } else {
-        throw std::runtime_error("Unsupported element type for wall");
+        makePolygon(wall.polygon);
     }
 }
 
 
-MapShapeBuilder::MapShapeBuilder(entt::registry &registry, Physics &physics):
+MapShapeBuilder::MapShapeBuilder(
+    entt::registry &registry,
+    Physics &physics,
+    const sf::Texture* spikeTexture,
+    const TextureAtlas* atlas
+):
     registry_(registry),
-    physics_(physics)
+    physics_(physics),
+    spikeTexture_(spikeTexture),
+    atlas_(atlas),
+    collisionTolerance_(COLLISION_TOLERANCE)
 {
-    spikeTexture_.loadFromFile("data/spike.png");
-    spikeTexture_.setRepeated(true);
-    spikeTexture_.setSmooth(true);
 }
 
-void MapShapeBuilder::makePlayer(const pugi::xml_node &node) {
-    Dimensions dimensions(node);
+void MapShapeBuilder::setCollisionTolerance(float tolerance) {
+    collisionTolerance_ = tolerance;
+}
+
+float MapShapeBuilder::getCollisionTolerance() const {
+    return collisionTolerance_;
+}
+
+const TextureAtlas* MapShapeBuilder::getAtlas() const {
+    return atlas_;
+}
+
+void MapShapeBuilder::loadSpikeTexture(sf::Texture &texture) {
+    if (!texture.loadFromFile(SPIKE_TEXTURE_PATH)) {
+        throw std::runtime_error("Could not load " + SPIKE_TEXTURE_PATH);
+    }
+
+    texture.setRepeated(true);
+    texture.setSmooth(true);
+}
+
+void MapShapeBuilder::addTextures(TextureAtlas &atlas) {
+    atlas.add(WALL_TEXTURE, "data/wall_texture.png");
+    atlas.add(WHEEL_TEXTURE, "data/wheel.png");
+    atlas.add(RUNNING_TEXTURE, "data/character/running.png");
+}
+
+void MapShapeBuilder::makeScenery(const LevelData &level) {
+    for (const auto& wall: level.walls) {
+        makeWall(wall);
+    }
+
+    for (const auto& zone: level.deathZones) {
+        makeDeathZone(zone);
+    }
+
+    for (const auto& checkpoint: level.checkpoints) {
+        makeCheckpoint(checkpoint);
+    }
+
+    for (const auto& decoration: level.decorations) {
+        makeDecoration(decoration);
+    }
+
+    SPDLOG_LOGGER_DEBUG(
+        log_,
+        "Added {} walls, {} death zones, {} checkpoints and {} decorations",
+        level.walls.size(),
+        level.deathZones.size(),
+        level.checkpoints.size(),
+        level.decorations.size()
+    );
+}
 
+void MapShapeBuilder::makePlayer(const sf::Vector2f &spawn) {
     // The rectangle player
     auto player = BodyBuilder(registry_, physics_)
-        .setPos(dimensions.x, dimensions.y)
+        .setPos(spawn.x, spawn.y)
         .setFixedRotation(true)
         .addRect(1, 2)
             .setColor(sf::Color(235, 186, 52))
@@ -121,7 +206,7 @@ void MapShapeBuilder::makePlayer(const pugi::xml_node &node) {
 
     // Follow the player, enable checkpoints and add a timer
     registry_.emplace<Follow>(player);
-    registry_.emplace<Respawnable>(player, sf::Vector2f(dimensions.x, dimensions.y), sf::seconds(2));
+    registry_.emplace<Respawnable>(player, spawn, sf::seconds(2));
     registry_.emplace<Timeable>(player);
 
     // Add movement to player
@@ -135,7 +220,7 @@ void MapShapeBuilder::makePlayer(const pugi::xml_node &node) {
 
     // The players arm
     auto arm = BodyBuilder(registry_, physics_)
-        .setPos(dimensions.x, dimensions.y)
+        .setPos(spawn.x, spawn.y)
         .addRect(0.3f, 1)
             .setColor(sf::Color(235, 186, 52))
             .setOutline(0.1f)
@@ -165,9 +250,7 @@ void MapShapeBuilder::makePlayer(const pugi::xml_node &node) {
 }
 
 
-entt::entity MapShapeBuilder::makeRect(const pugi::xml_node& node) {
-    Dimensions dimensions(node);
-
+entt::entity MapShapeBuilder::makeRect(const Dimensions& dimensions) {
     return BodyBuilder(registry_, physics_)
         .setPos(dimensions.x, dimensions.y)
         .setType(b2_staticBody)
@@ -180,73 +263,73 @@ entt::entity MapShapeBuilder::makeRect(const pugi::xml_node& node) {
         .create();
 }
 
-entt::entity MapShapeBuilder::makePolygon(const pugi::xml_node &node) {
-    auto svgPoints = node.attribute("d").as_string();
-    auto points = PathBuilder::build(svgPoints);
-
+entt::entity MapShapeBuilder::makePolygon(const LevelPolygon &polygon) {
     return BodyBuilder(registry_, physics_)
         .setPos(0, 0)
         .setType(b2_staticBody)
-            .addPolygon(points)
+            .addMesh(polygon.outline, polygon.mesh)
             .setColor(WALL_COLOUR)
             .draw()
             .setZIndex(WALL_Z_INDEX)
             .makeFixture()
+            .setCollisionTolerance(collisionTolerance_)
             .attachToBody()
         .create();
 }
 
-entt::entity MapShapeBuilder::makeDeathZone(const pugi::xml_node &node) {
+entt::entity MapShapeBuilder::makeDeathZone(const LevelDeathZone &zone) {
     entt::entity entity;
+    bool spikes = zone.spikes;
 
-    auto label = node.attribute("inkscape:label");
-    bool spikes = strcmp(label.value(), "spikes") == 0;
+    if (zone.shape.type == LevelShape::Type::RECT) {
+        const auto& dimensions = zone.shape.rect;
 
-    if (strcmp(node.name(), "rect") == 0) {
-        Dimensions dimensions(node);
-        int textureWidth = spikeTexture_.getSize().x * dimensions.width;
-
-        entity = BodyBuilder(registry_, physics_)
+        auto bodyBuilder = BodyBuilder(registry_, physics_);
+        auto shapeBuilder = bodyBuilder
             .setPos(dimensions.x, dimensions.y)
             .setType(b2_staticBody)
-            .addRect(dimensions.width, dimensions.height)
-                .setSensor()
-                .draw(spikes)
-                .setTexture(&spikeTexture_)
-                .setTextureRect(sf::IntRect(1, 1, textureWidth, spikeTexture_.getSize().y))
-                .makeFixture()
-                .attachToBody()
-            .create();
+            .addRect(dimensions.width, dimensions.height);
+
+        shapeBuilder
+            .setSensor()
+            .draw(spikes)
+            .makeFixture();
+
+        if (spikeTexture_) {
+            int textureWidth = spikeTexture_->getSize().x * dimensions.width;
 
-    } else if (strcmp(node.name(), "path") == 0) {
-        auto svgPoints = node.attribute("d").as_string();
-        auto points = PathBuilder::build(svgPoints);
+            shapeBuilder
+                .setTexture(spikeTexture_)
+                .setTextureRect(sf::IntRect(1, 1, textureWidth, spikeTexture_->getSize().y));
+        }
 
+        entity = shapeBuilder
+            .attachToBody()
+            .create();
+
+    } else {
         entity = BodyBuilder(registry_, physics_)
             .setPos(0, 0)
             .setType(b2_staticBody)
-            .addPolygon(points)
+            .addMesh(zone.shape.polygon.outline, zone.shape.polygon.mesh)
                 .makeFixture()
+                .setCollisionTolerance(collisionTolerance_)
                 .setSensor()
                 .attachToBody()
             .create();
-    } else {
-        throw std::runtime_error("Unsupported element type for death zone");
     }
 
     registry_.emplace<DeathZone>(entity, DeathZone {spikes = spikes});
     return entity;
 }
 
-void MapShapeBuilder::makeCheckpoint(const pugi::xml_node &node) {
+void MapShapeBuilder::makeCheckpoint(const LevelCheckpoint &checkpoint) {
     entt::entity entity;
     sf::Vector2f respawnLoc(0, 0);
+    bool finish = checkpoint.finish;
 
-    auto label = node.attribute("inkscape:label");
-    bool finish = strcmp(label.value(), "finish") == 0;
-
-    if (strcmp(node.name(), "rect") == 0) {
-        Dimensions dimensions(node);
+    if (checkpoint.shape.type == LevelShape::Type::RECT) {
+        const auto& dimensions = checkpoint.shape.rect;
 
         entity = BodyBuilder(registry_, physics_)
             .setPos(dimensions.x, dimensions.y)
@@ -260,45 +343,33 @@ void MapShapeBuilder::makeCheckpoint(const pugi::xml_node &node) {
         // Respawn at the bottom of the checkpoint with a small jump for the player
         respawnLoc = sf::Vector2f(dimensions.x, (dimensions.y - dimensions.height / 2.f) + 2.3f);
     } else {
-        auto svgPoints = node.attribute("d").as_string();
-        auto points = PathBuilder::build(svgPoints);
-
         entity = BodyBuilder(registry_, physics_)
             .setType(b2_staticBody)
-            .addPolygon(points)
+            .addMesh(checkpoint.shape.polygon.outline, checkpoint.shape.polygon.mesh)
                 .setSensor()
                 .makeFixture()
+                .setCollisionTolerance(collisionTolerance_)
                 .attachToBody()
             .create();
-
-        if (!finish) {
-            throw std::runtime_error("Polyagonal checkpoints are only supported for finishing lines");
-        }
     }
 
     registry_.emplace<Checkpoint>(entity, respawnLoc, finish);
 }
 
-void MapShapeBuilder::makeDecoration(const pugi::xml_node &node) {
-    if (strcmp(node.name(), "rect") == 0) {
-        Dimensions dimensions(node);
+void MapShapeBuilder::makeDecoration(const LevelShape &decoration) {
+    if (decoration.type == LevelShape::Type::RECT) {
+        const auto& dimensions = decoration.rect;
         ShapeBuilder::CreateRect(dimensions.width, dimensions.height)
             .setPos(dimensions.x - dimensions.width / 2.f, dimensions.y - dimensions.height / 2.f)
             .setColor(DECORATION_COLOUR)
             .setZIndex(DECORATION_Z_INDEX)
             .create(registry_);
 
-    } else if (strcmp(node.name(), "path") == 0) {
-        auto svgPoints = node.attribute("d").as_string();
-        auto points = PathBuilder::build(svgPoints);
-
-        ShapeBuilder::CreatePolygon(points)
+    } else {
+        const auto& polygon = decoration.polygon;
+        ShapeBuilder::CreateMesh(polygon.outline, polygon.mesh, polygon.detailLevels)
             .setColor(DECORATION_COLOUR)
             .setZIndex(DECORATION_Z_INDEX)
             .create(registry_);
-    } else {
-        throw std::runtime_error("Unsupported element type for death zone");
     }
 }
-
-
@@ -6,44 +6,80 @@
 #define SLINGER_MAP_MAKER_H
 
 #include <entt/entity/registry.hpp>
-#include <variant>
-#include <regex>
 
 #include "physics.h"
-#include "pugixml.hpp"
 #include "body_builder.h"
-
-struct Dimensions {
-    float x;
-    float y;
-    float width;
-    float height;
-
-    Dimensions(const pugi::xml_node &node);
-};
+#include "texture_atlas.h"
+#include "level_data.h"
+#include "thread_pool.h"
+#include "level_pager.h"
+#include "endless_map.h"
+#include "logging.h"
 
 /**
- * Builds Box2d bodies and sfml shapes from svg shapes
+ * Builds Box2d bodies and sfml shapes from level data
  */
 class MapShapeBuilder {
     entt::registry& registry_;
     Physics& physics_;
-
-    sf::Texture spikeTexture_;
+    const sf::Texture* spikeTexture_;
+    const TextureAtlas* atlas_;
+    float collisionTolerance_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::MAP);
 
 public:
-    MapShapeBuilder(entt::registry& registry, Physics& physics);
-
-    void makePlayer(const pugi::xml_node &node);
-    void makeWall(const pugi::xml_node& node);
-    void makeDecoration(const pugi::xml_node& node);
-
-    entt::entity makeDeathZone(const pugi::xml_node &node);
-    void makeCheckpoint(const pugi::xml_node &node);
+    static const std::string SPIKE_TEXTURE_PATH;
+    static const std::string WALL_TEXTURE;
+    static const std::string WHEEL_TEXTURE;
+    static const std::string RUNNING_TEXTURE;
+
+    /**
+     * @param spikeTexture tiled across death zones, they are left untextured without one
+     * @param atlas the rest of the level and character art, packed so it shares textures
+     */
+    MapShapeBuilder(
+        entt::registry& registry,
+        Physics& physics,
+        const sf::Texture* spikeTexture = nullptr,
+        const TextureAtlas* atlas = nullptr
+    );
+
+    /**
+     * Load the texture spikes are drawn with, it has to repeat to be tiled along a death zone
+     */
+    static void loadSpikeTexture(sf::Texture& texture);
+
+    /**
+     * Queue every image that is drawn within its own bounds onto the atlas
+     */
+    static void addTextures(TextureAtlas& atlas);
+
+    /**
+     * Set how far polygon fixtures may stray from the authored path when they are simplified
+     */
+    void setCollisionTolerance(float tolerance);
+    [[nodiscard]] float getCollisionTolerance() const;
+
+    /**
+     * The packed art shapes can be textured from with ShapeBuilder::setTexture, if there is any
+     */
+    [[nodiscard]] const TextureAtlas* getAtlas() const;
+
+    /**
+     * Add every wall, zone, checkpoint and decoration in the level
+     */
+    void makeScenery(const LevelData& level);
+
+    void makePlayer(const sf::Vector2f& spawn);
+    void makeWall(const LevelShape& wall);
+    void makeDecoration(const LevelShape& decoration);
+
+    entt::entity makeDeathZone(const LevelDeathZone& zone);
+    void makeCheckpoint(const LevelCheckpoint& checkpoint);
 
 private:
-    entt::entity makeRect(const pugi::xml_node& node);
-    entt::entity makePolygon(const pugi::xml_node &node);
+    entt::entity makeRect(const Dimensions& dimensions);
+    entt::entity makePolygon(const LevelPolygon& polygon);
 
     static const int BASE_Z_INDEX;
     static const int PLAYER_BODY_Z_INDEX;
@@ -56,17 +92,51 @@ private:
     static const sf::Color DECORATION_OUTLINE_COLOUR;
     static const float DECORATION_OUTLINE_THICKNESS;
 
+    static const float COLLISION_TOLERANCE;
+
 };
 
 /**
- * Builds a level from an svg
+ * Builds a level from an svg, going through its cooked copy when there is an up to date one
  */
 class MapMaker {
+    entt::registry& registry_;
     MapShapeBuilder mapShapeBuilder_;
+    LevelPager pager_;
+    EndlessMap endless_;
+    ThreadPool* pool_ = nullptr;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::MAP);
 
 public:
-    MapMaker(entt::registry& registry, Physics& physics);
-    void make(const std::string& path);
+    MapMaker(
+        entt::registry& registry,
+        Physics& physics,
+        const sf::Texture* spikeTexture = nullptr,
+        const TextureAtlas* atlas = nullptr
+    );
+
+    /**
+     * Load a level and add the part of it around the player to the world
+     * @param pool if given, the level is read in parallel and pages are loaded in the background
+     */
+    void make(const std::string& path, ThreadPool* pool = nullptr);
+
+    /**
+     * Start an endless climb and add the player at the bottom of it
+     * @param pool if given, chunks are generated in the background
+     */
+    void makeEndless(std::uint32_t seed, ThreadPool* pool = nullptr);
+
+    /**
+     * Page the level, or the chunks of an endless climb, in and out around the followed entity
+     */
+    void update();
+
+    /**
+     * Add everything in a level to the world at once, this has to happen on the thread that owns it
+     */
+    void build(const LevelData& level);
+    void setCollisionTolerance(float tolerance);
 };
 
 #endif //SLINGER_MAP_MAKER_H
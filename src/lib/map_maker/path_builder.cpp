@@ -2,196 +2,389 @@
 // Created by derek on 22/10/20.
 //
 
-#include <set>
-#include <optional>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
 #include "path_builder.h"
 
-const Regexer PathBuilder::COMMAND_REGEX = Regexer(R"(\s?([a-df-zA-Z])(?:\s([^a-df-zA-Z]+))?)");
-const Regexer PathBuilder::COORDINATE_REGEX = Regexer(R"((-?\d+\.?\d*(?:e-?\d+)?))");
+const float PathBuilder::CURVE_TOLERANCE = 0.01f;
+const int PathBuilder::MAX_CURVE_DEPTH = 10;
 
-PathBuilder::CommandList PathBuilder::getCommands(const std::string &svgPath) {
-    auto list = PathBuilder::CommandList();
+namespace {
+    const float PI = 3.141592654f;
 
-    // Iterate over every command: argument pair in the SVG path
-    for (const auto& commandStr : COMMAND_REGEX.search(svgPath)) {
-        if (commandStr.groups().size() != 2) {
-            throw std::runtime_error("Could not parse svg path: " + svgPath);
-        }
+    // Svg has y pointing down and box2d has it pointing up
+    void addPoint(PointList &points, const sf::Vector2f &point) {
+        points.emplace_back(point.x, -point.y);
+    }
 
-        auto commandName = commandStr.groups().at(0);
-        auto numbersStr = commandStr.groups().at(1);
+    float cross(const sf::Vector2f &lhs, const sf::Vector2f &rhs) {
+        return lhs.x * rhs.y - lhs.y * rhs.x;
+    }
 
-        if (!COMMAND_NAMES.contains(commandName)) {
-            throw std::runtime_error("Could not find svg path command: " + commandName);
-        }
+    float lengthSquared(const sf::Vector2f &vector) {
+        return vector.x * vector.x + vector.y * vector.y;
+    }
+}
 
-        auto command = COMMAND_NAMES.at(commandName);
-        Arguments arguments;
+PathScanner::PathScanner(std::string_view path): path_(path) {
 
-        if (numbersStr.empty()) {
-            arguments = std::monostate {};
-        }
-        else {
-            const auto& numbers = COORDINATE_REGEX.search(numbersStr);
-
-            // String contains a list of coordinates
-            if (PathBuilder::isPointList(command, numbersStr)) {
-                PointList list;
-                std::optional<float> lastCoord;
-                for (const auto& x : numbers) {
-                    auto number = std::atof(x.matchedString().c_str());
-
-                    if (!lastCoord) {
-                        lastCoord = number;
-                    } else {
-                        list.push_back(sf::Vector2f(lastCoord.value(), number));
-                        lastCoord.reset();
-                    }
-                }
-                arguments = list;
-            } else {
-                std::vector<float> floatList;
-                for (const auto& x : numbers) {
-                    auto number = std::atof(x.matchedString().c_str());
-                    floatList.emplace_back(number);
-                }
-                arguments = floatList;
-            }
-        }
+}
+
+bool PathScanner::atEnd() {
+    skipSeparators();
+    return position_ >= path_.size();
+}
+
+std::optional<char> PathScanner::command() {
+    skipSeparators();
+
+    if (position_ >= path_.size()) {
+        return std::optional<char>();
+    }
+
+    char c = path_[position_];
 
-        list.emplace_back(command, arguments);
+    // Exponents are the only letters that can appear in a number
+    bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    if (!letter || c == 'e' || c == 'E') {
+        return std::optional<char>();
     }
 
-    return list;
+    position_++;
+    return c;
 }
 
-PointList PathBuilder::getPoints(const PathBuilder::CommandList &commands) {
-    auto list = PointList();
+float PathScanner::number() {
+    skipSeparators();
 
-    for (const auto& commandPair : commands) {
-        Command command = commandPair.first;
-        Arguments arguments = commandPair.second;
-        //m 18.35551,3.2577749 v 3.621956 l -5.472546,0.019407 1.727002,-2.6997475 z
+    // from_chars doesn't accept a leading plus
+    if (position_ < path_.size() && path_[position_] == '+') {
+        position_++;
+    }
 
-        if (command == Command::MoveTo || command == Command::RelativeMoveTo) {
-            if (!std::holds_alternative<PointList>(arguments)) {
-                throw std::runtime_error("Unsupported arguments for MoveTo");
-            }
+    float value = 0;
+    const char *begin = path_.data() + position_;
+    const char *end = path_.data() + path_.size();
+    auto [next, error] = std::from_chars(begin, end, value);
 
-            auto points = std::get<PointList>(arguments);
-            auto point = points.at(0);
-            point.y *= -1.f;
-            list.emplace_back(point);
+    if (error != std::errc() || next == begin) {
+        throw std::runtime_error("Could not parse svg path: " + std::string(path_));
+    }
 
-            if (points.size() > 1) {
-                command = command == Command::MoveTo ? Command::LineTo : Command::RelativeLineTo;
-                arguments = PointList(points.begin() + 1, points.end());
-            }
-        }
+    position_ += next - begin;
+    return value;
+}
 
-        if (command == Command::LineTo) {
-            if (!std::holds_alternative<PointList>(arguments)) {
-                throw std::runtime_error("Unsupported arguments for LineTo");
-            }
+sf::Vector2f PathScanner::point() {
+    // Read in two statements, the order arguments are evaluated in isn't defined
+    float x = number();
+    float y = number();
 
-            auto points = std::get<PointList>(arguments);
-            for (auto point : points)
-            {
-                point.y *= -1.f;
-                list.emplace_back(point);
-            }
-        }
+    return sf::Vector2f(x, y);
+}
 
-        if (command == Command::RelativeLineTo) {
-            if (!std::holds_alternative<PointList>(arguments)) {
-                throw std::runtime_error("Unsupported arguments for RelativeLineTo");
-            }
+bool PathScanner::flag() {
+    skipSeparators();
 
-            auto points = std::get<PointList>(arguments);
-            for (auto point : points)
-            {
-                point.y *= -1.f;
-                point = list.back() + point;
-                list.emplace_back(point);
-            }
-        }
+    if (position_ >= path_.size() || (path_[position_] != '0' && path_[position_] != '1')) {
+        throw std::runtime_error("Could not parse svg path: " + std::string(path_));
+    }
 
-        if (command == Command::HorizontalLineTo) {
-            if (!std::holds_alternative<std::vector<float>>(arguments)) {
-                throw std::runtime_error("Unsupported arguments for HorizontalLineTo");
-            }
+    return path_[position_++] == '1';
+}
 
-            for (float x : std::get<std::vector<float>>(arguments)) {
-                auto point = sf::Vector2f(x, list.back().y);
-                list.emplace_back(point);
-            }
+void PathScanner::skipSeparators() {
+    while (position_ < path_.size()) {
+        char c = path_[position_];
+
+        if (c != ' ' && c != ',' && c != '\n' && c != '\r' && c != '\t' && c != '\f') {
+            return;
         }
 
-        if (command == Command::RelativeHorizontalLineTo) {
-            if (!std::holds_alternative<std::vector<float>>(arguments)) {
-                throw std::runtime_error("Unsupported arguments for RelativeHorizontalLineTo");
-            }
+        position_++;
+    }
+}
 
-            for (float x : std::get<std::vector<float>>(arguments)) {
-                auto point = list.back() + sf::Vector2f(x, 0);
-                list.emplace_back(point);
-            }
-        }
+PointList PathBuilder::build(const std::string &string, float tolerance) {
+    PointList points;
+    build(string, points, nullptr, tolerance);
 
-        if (command == Command::VerticalLineTo) {
-            if (!std::holds_alternative<std::vector<float>>(arguments)) {
-                throw std::runtime_error("Unsupported arguments for VerticalLineTo");
-            }
+    return points;
+}
 
-            for (float x : std::get<std::vector<float>>(arguments)) {
-                auto point = sf::Vector2f(list.back().x, -x);
-                list.emplace_back(point);
+void PathBuilder::build(
+    std::string_view path,
+    PointList &points,
+    std::vector<std::size_t> *contourStarts,
+    float tolerance
+) {
+    PathScanner scanner(path);
+
+    const std::size_t first = points.size();
+
+    // Positions are kept in svg space and only flipped as they are added
+    sf::Vector2f current;
+    sf::Vector2f start;
+    sf::Vector2f control;
+    char command = 0;
+    char previous = 0;
+
+    while (!scanner.atEnd()) {
+        if (auto next = scanner.command()) {
+            command = next.value();
+
+            if (command == 'Z' || command == 'z') {
+                current = start;
+                addPoint(points, current);
+                previous = command;
+                continue;
             }
+        } else if (command == 0) {
+            throw std::runtime_error("Could not parse svg path: " + std::string(path));
         }
 
-        if (command == Command::RelativeVerticalLineTo) {
-            if (!std::holds_alternative<std::vector<float>>(arguments)) {
-                throw std::runtime_error("Unsupported arguments for RelativeVerticalLineTo");
+        // Relative commands are lower case
+        const bool relative = command >= 'a';
+        const sf::Vector2f origin = relative ? current : sf::Vector2f();
+
+        // Numbers without a command repeat the last one
+        switch (command) {
+            case 'M':
+            case 'm': {
+                auto point = scanner.point();
+
+                // The first move of a path is always absolute
+                if (relative && points.size() > first) {
+                    point += current;
+                }
+
+                if (contourStarts) {
+                    contourStarts->push_back(points.size());
+                }
+
+                current = start = point;
+                addPoint(points, current);
+
+                // Any more points after a move are lines
+                command = relative ? 'l' : 'L';
+                break;
+            }
+            case 'L':
+            case 'l':
+                current = origin + scanner.point();
+                addPoint(points, current);
+                break;
+            case 'H':
+            case 'h':
+                current.x = origin.x + scanner.number();
+                addPoint(points, current);
+                break;
+            case 'V':
+            case 'v':
+                current.y = origin.y + scanner.number();
+                addPoint(points, current);
+                break;
+            case 'C':
+            case 'c': {
+                auto control1 = origin + scanner.point();
+                control = origin + scanner.point();
+                auto end = origin + scanner.point();
+
+                flattenCubic(points, current, control1, control, end, tolerance);
+                current = end;
+                break;
+            }
+            case 'S':
+            case 's': {
+                // The first control point mirrors the last one if the previous segment was a cubic too
+                bool smooth = previous == 'C' || previous == 'c' || previous == 'S' || previous == 's';
+                auto control1 = smooth ? current * 2.f - control : current;
+                control = origin + scanner.point();
+                auto end = origin + scanner.point();
+
+                flattenCubic(points, current, control1, control, end, tolerance);
+                current = end;
+                break;
             }
+            case 'Q':
+            case 'q':
+            case 'T':
+            case 't': {
+                if (command == 'Q' || command == 'q') {
+                    control = origin + scanner.point();
+                } else {
+                    bool smooth = previous == 'Q' || previous == 'q' || previous == 'T' || previous == 't';
+                    control = smooth ? current * 2.f - control : current;
+                }
 
-            for (float x : std::get<std::vector<float>>(arguments)) {
-                auto point =  list.back() + sf::Vector2f(0, -x);
-                list.emplace_back(point);
+                auto end = origin + scanner.point();
+
+                // Every quadratic can be written exactly as a cubic
+                flattenCubic(
+                    points,
+                    current,
+                    current + (control - current) * (2.f / 3.f),
+                    end + (control - end) * (2.f / 3.f),
+                    end,
+                    tolerance
+                );
+                current = end;
+                break;
+            }
+            case 'A':
+            case 'a': {
+                auto radii = scanner.point();
+                float rotation = scanner.number();
+                bool largeArc = scanner.flag();
+                bool sweep = scanner.flag();
+                auto end = origin + scanner.point();
+
+                flattenArc(points, current, radii, rotation, largeArc, sweep, end, tolerance);
+                current = end;
+                break;
             }
+            case 'Z':
+            case 'z':
+                throw std::runtime_error("Unsupported arguments for ClosePath");
+            default:
+                throw std::runtime_error("Could not find svg path command: " + std::string(1, command));
         }
 
-        if (command == Command::ClosePath || command == Command::RelativeClosePath) {
-            if (!std::holds_alternative<std::monostate>(arguments)) {
-                throw std::runtime_error("Unsupported arguments for ClosePath");
-            }
+        previous = command;
+    }
+}
 
-            list.emplace_back(list.at(0));
-        }
+std::vector<PointList> PathBuilder::buildContours(const std::string &string, float tolerance) {
+    std::vector<std::size_t> starts;
+    PointList points;
+    build(string, points, &starts, tolerance);
+
+    std::vector<PointList> contours;
+    for (std::size_t i = 0; i < starts.size(); i++) {
+        auto end = i + 1 < starts.size() ? starts[i + 1] : points.size();
+        contours.emplace_back(points.begin() + (long) starts[i], points.begin() + (long) end);
     }
 
-    return list;
+    return contours;
 }
 
-PointList PathBuilder::build(const std::string &string) {
-    auto commands = getCommands(string);
+void PathBuilder::flattenCubic(
+    PointList &points,
+    const sf::Vector2f &p0,
+    const sf::Vector2f &p1,
+    const sf::Vector2f &p2,
+    const sf::Vector2f &p3,
+    float tolerance,
+    int depth
+) {
+    // The curve stays inside the hull of its control points, so it is flat enough once both
+    // control points are within tolerance of the chord
+    auto chord = p3 - p0;
+    auto chordSquared = lengthSquared(chord);
+    auto limit = tolerance * tolerance;
+    bool flat;
+
+    if (chordSquared > 0) {
+        auto d1 = cross(chord, p1 - p0);
+        auto d2 = cross(chord, p2 - p0);
+        flat = std::max(d1 * d1, d2 * d2) <= limit * chordSquared;
+    } else {
+        flat = std::max(lengthSquared(p1 - p0), lengthSquared(p2 - p0)) <= limit;
+    }
 
-    return getPoints(commands);
+    if (flat || depth >= MAX_CURVE_DEPTH) {
+        addPoint(points, p3);
+        return;
+    }
+
+    // Split in half with de Casteljau's algorithm
+    auto p01 = (p0 + p1) / 2.f;
+    auto p12 = (p1 + p2) / 2.f;
+    auto p23 = (p2 + p3) / 2.f;
+    auto p012 = (p01 + p12) / 2.f;
+    auto p123 = (p12 + p23) / 2.f;
+    auto middle = (p012 + p123) / 2.f;
+
+    flattenCubic(points, p0, p01, p012, middle, tolerance, depth + 1);
+    flattenCubic(points, middle, p123, p23, p3, tolerance, depth + 1);
 }
 
-bool PathBuilder::isPointList(Command command, const std::string &arguments) {
-    const static std::set<Command> pointsListCommands = {
-        Command::MoveTo,
-        Command::RelativeMoveTo,
-        Command::LineTo,
-        Command::RelativeLineTo
-    };
+void PathBuilder::flattenArc(
+    PointList &points,
+    const sf::Vector2f &from,
+    sf::Vector2f radii,
+    float rotation,
+    bool largeArc,
+    bool sweep,
+    const sf::Vector2f &to,
+    float tolerance
+) {
+    if (from == to) {
+        return;
+    }
+
+    radii.x = std::abs(radii.x);
+    radii.y = std::abs(radii.y);
+
+    if (radii.x == 0 || radii.y == 0) {
+        addPoint(points, to);
+        return;
+    }
+
+    // Convert from end points to a centre, following the svg implementation notes
+    const float cosine = std::cos(rotation * PI / 180.f);
+    const float sine = std::sin(rotation * PI / 180.f);
+    const auto half = (from - to) / 2.f;
+    const sf::Vector2f p(cosine * half.x + sine * half.y, -sine * half.x + cosine * half.y);
+
+    // Radii too small to reach the end point are scaled up until they just do
+    float lambda = (p.x * p.x) / (radii.x * radii.x) + (p.y * p.y) / (radii.y * radii.y);
+    if (lambda > 1) {
+        radii *= std::sqrt(lambda);
+    }
+
+    const float rx2 = radii.x * radii.x;
+    const float ry2 = radii.y * radii.y;
+    const float denominator = rx2 * p.y * p.y + ry2 * p.x * p.x;
+    float coefficient = std::sqrt(std::max(0.f, (rx2 * ry2 - denominator) / denominator));
+    if (largeArc == sweep) {
+        coefficient = -coefficient;
+    }
+
+    const sf::Vector2f centreP(coefficient * radii.x * p.y / radii.y, -coefficient * radii.y * p.x / radii.x);
+    const sf::Vector2f centre(
+        cosine * centreP.x - sine * centreP.y + (from.x + to.x) / 2.f,
+        sine * centreP.x + cosine * centreP.y + (from.y + to.y) / 2.f
+    );
+
+    const float startAngle = std::atan2((p.y - centreP.y) / radii.y, (p.x - centreP.x) / radii.x);
+    const float endAngle = std::atan2((-p.y - centreP.y) / radii.y, (-p.x - centreP.x) / radii.x);
+    float sweepAngle = endAngle - startAngle;
+
+    if (!sweep && sweepAngle > 0) {
+        sweepAngle -= 2 * PI;
+    } else if (sweep && sweepAngle < 0) {
+        sweepAngle += 2 * PI;
+    }
+
+    // A chord spanning an angle of step sags r(1 - cos(step / 2)) from the circle
+    const float radius = std::max(radii.x, radii.y);
+    float step = PI / 2.f;
+    if (tolerance > 0 && tolerance < radius) {
+        step = std::min(step, 2.f * std::acos(1.f - tolerance / radius));
+    }
+
+    const int segments = std::max(1, (int) std::ceil(std::abs(sweepAngle) / step));
+
+    for (int i = 1; i < segments; i++) {
+        float angle = startAngle + sweepAngle * (float) i / (float) segments;
+        float x = radii.x * std::cos(angle);
+        float y = radii.y * std::sin(angle);
 
-    // For certain commands the comma is optional so we need to hard code a check for
-    // those commands
-    if (pointsListCommands.contains(command)) {
-        return true;
+        addPoint(points, sf::Vector2f(cosine * x - sine * y + centre.x, sine * x + cosine * y + centre.y));
     }
 
-    // Otherwise just check to see if the string has a comma, this is probably not needed
-    return arguments.find(',') != std::string::npos;
+    // Land exactly on the end point rather than wherever rounding leaves the last step
+    addPoint(points, to);
 }
@@ -5,54 +5,106 @@
 #ifndef SLINGER_PATH_BUILDER_H
 #define SLINGER_PATH_BUILDER_H
 
-#include <variant>
-#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
-#include <entt/entity/registry.hpp>
-#include <SFML/Main.hpp>
 #include <SFML/System/Vector2.hpp>
 
-#include "regexer.h"
-
 
 namespace {
     using PointList = std::vector<sf::Vector2f>;
 }
 
 /**
- * Fetches a list of vertices from an svg path
+ * Reads the tokens of an svg path in place, without copying or allocating
  */
-class PathBuilder {
-    enum class Command: char {
-        MoveTo, RelativeMoveTo, LineTo, HorizontalLineTo, VerticalLineTo,
-        RelativeLineTo, RelativeHorizontalLineTo, RelativeVerticalLineTo, ClosePath, RelativeClosePath
-    };
-
-    const static inline std::map<std::string, Command> COMMAND_NAMES = {
-        {"M", Command::MoveTo},
-        {"m", Command::RelativeMoveTo},
-        {"L", Command::LineTo},
-        {"H", Command::HorizontalLineTo},
-        {"V", Command::VerticalLineTo},
-        {"l", Command::RelativeLineTo},
-        {"h", Command::RelativeHorizontalLineTo},
-        {"v", Command::RelativeVerticalLineTo},
-        {"Z", Command::ClosePath},
-        {"z", Command::RelativeClosePath}
-    };
-
-    using Arguments = std::variant<std::monostate, std::vector<float>, std::vector<sf::Vector2f>>;
-    using CommandList = std::vector<std::pair<Command, Arguments>>;
-
-    static CommandList getCommands(const std::string& svgPath);
-    static PointList getPoints(const CommandList& list);
-    static bool isPointList(Command command, const std::string &arguments);
+class PathScanner {
+    std::string_view path_;
+    std::size_t position_ = 0;
 
 public:
-    const static Regexer COMMAND_REGEX;
-    const static Regexer COORDINATE_REGEX;
+    explicit PathScanner(std::string_view path);
+
+    [[nodiscard]] bool atEnd();
+
+    /**
+     * Consume the next command letter if the next token is one
+     */
+    std::optional<char> command();
+
+    /**
+     * Consume the next number, throwing if the next token isn't one
+     */
+    float number();
+
+    /**
+     * Consume the next pair of numbers as a point
+     */
+    sf::Vector2f point();
+
+    /**
+     * Consume an arc flag, these are a single digit and don't need separating from what follows
+     */
+    bool flag();
+
+private:
+    void skipSeparators();
+};
+
+/**
+ * Fetches a list of vertices from an svg path, curves are flattened into line segments
+ */
+class PathBuilder {
+public:
+    // The furthest a flattened curve may stray from the real one, in world units
+    static const float CURVE_TOLERANCE;
+
+    static PointList build(const std::string& string, float tolerance = CURVE_TOLERANCE);
+
+    /**
+     * Append the vertices of an svg path to a buffer
+     * @param path the svg path data
+     * @param points the buffer to add the vertices to
+     * @param contourStarts if given, the index in points of the start of each sub path is added
+     * @param tolerance how far line segments may be from the curves they replace
+     */
+    static void build(
+        std::string_view path,
+        PointList& points,
+        std::vector<std::size_t>* contourStarts = nullptr,
+        float tolerance = CURVE_TOLERANCE
+    );
+
+    /**
+     * Fetch the vertices of every sub path separately, each move command starts a new contour
+     */
+    static std::vector<PointList> buildContours(const std::string& string, float tolerance = CURVE_TOLERANCE);
+
+private:
+    static const int MAX_CURVE_DEPTH;
+
+    static void flattenCubic(
+        PointList& points,
+        const sf::Vector2f& p0,
+        const sf::Vector2f& p1,
+        const sf::Vector2f& p2,
+        const sf::Vector2f& p3,
+        float tolerance,
+        int depth = 0
+    );
 
-    static PointList build(const std::string& string);
+    static void flattenArc(
+        PointList& points,
+        const sf::Vector2f& from,
+        sf::Vector2f radii,
+        float rotation,
+        bool largeArc,
+        bool sweep,
+        const sf::Vector2f& to,
+        float tolerance
+    );
 };
 
 
@@ -6,22 +6,20 @@
 
 
 std::vector<Match> Regexer::search(const std::string& string) const {
-    std::string searchString = string;
     std::vector<Match> matches;
 
-    auto matchResults = std::smatch{};
-    while(std::regex_search(searchString, matchResults, regex_))
-    {
-        matches.emplace_back(Match(matchResults));
-
-
-        // Remove the captured string from the path and try again
-        searchString = matchResults.suffix();
+    for (const auto &match : this->matches(string)) {
+        matches.emplace_back(match);
     }
 
     return matches;
 }
 
+MatchRange Regexer::matches(std::string_view searchString) const {
+    // Iterating continues each search from the end of the last match, no need to copy the rest
+    return MatchRange(std::cregex_iterator(searchString.data(), searchString.data() + searchString.size(), regex_));
+}
+
 Regexer::Regexer(const std::string &regex): regex_(regex) {
 
 }
@@ -37,10 +35,80 @@ Match::Match(const std::smatch &results): matchedString_(results.str()) {
     }
 }
 
-const std::vector<std::string> Match::groups() const {
+Match::Match(const MatchView &match): matchedString_(match.matchedString()) {
+    groups_.reserve(match.groupCount());
+
+    for (std::size_t i = 0; i < match.groupCount(); i++) {
+        groups_.emplace_back(match.group(i));
+    }
+}
+
+const std::vector<std::string>& Match::groups() const {
     return groups_;
 }
 
 const std::string& Match::matchedString() const {
     return matchedString_;
 }
+
+MatchView::MatchView(const std::cmatch &results): results_(results) {
+
+}
+
+std::string_view MatchView::matchedString() const {
+    return std::string_view(results_[0].first, results_[0].length());
+}
+
+std::string_view MatchView::group(std::size_t index) const {
+    const auto &group = results_[index + 1];
+
+    // Groups that didn't take part in the match are empty, like they are as strings
+    if (!group.matched) {
+        return std::string_view();
+    }
+
+    return std::string_view(group.first, group.length());
+}
+
+std::size_t MatchView::groupCount() const {
+    return results_.size() - 1;
+}
+
+MatchRange::MatchRange(std::cregex_iterator begin): begin_(std::move(begin)) {
+
+}
+
+MatchRange::iterator MatchRange::begin() const {
+    return iterator(begin_);
+}
+
+MatchRange::iterator MatchRange::end() const {
+    return iterator();
+}
+
+MatchRange::iterator::iterator(std::cregex_iterator current): current_(std::move(current)) {
+
+}
+
+MatchView MatchRange::iterator::operator*() const {
+    return MatchView(*current_);
+}
+
+MatchRange::iterator &MatchRange::iterator::operator++() {
+    ++current_;
+    return *this;
+}
+
+MatchRange::iterator MatchRange::iterator::operator++(int) {
+    auto previous = *this;
+    ++current_;
+    return previous;
+}
+
+bool MatchRange::iterator::operator==(const MatchRange::iterator &other) const {
+    return current_ == other.current_;
+}
+
+bool MatchRange::iterator::operator!=(const MatchRange::iterator &other) const {
+    return current_ != other.current_;
+}
@@ -3,15 +3,64 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <regex>
 
+/**
+ * A match that points into the searched string instead of copying it, only valid while that string is
+ */
+class MatchView {
+    const std::cmatch& results_;
+public:
+    explicit MatchView(const std::cmatch& results);
+    std::string_view matchedString() const;
+
+    /**
+     * Fetch a capture group, starting from 0 for the first group rather than the whole match
+     */
+    std::string_view group(std::size_t index) const;
+    std::size_t groupCount() const;
+};
+
+/**
+ * Lazily finds each match as it is iterated over
+ */
+class MatchRange {
+    std::cregex_iterator begin_;
+
+public:
+    class iterator {
+        std::cregex_iterator current_;
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = MatchView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = MatchView;
+
+        iterator() = default;
+        explicit iterator(std::cregex_iterator current);
+
+        MatchView operator*() const;
+        iterator& operator++();
+        iterator operator++(int);
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+    };
+
+    explicit MatchRange(std::cregex_iterator begin);
+    iterator begin() const;
+    iterator end() const;
+};
+
 class Match {
     std::vector<std::string> groups_;
     std::string matchedString_;
 public:
     explicit Match(const std::smatch& results);
+    explicit Match(const MatchView& match);
     const std::string& matchedString() const;
-    const std::vector<std::string> groups() const;
+    const std::vector<std::string>& groups() const;
 };
 
 class Regexer {
@@ -20,5 +69,10 @@ class Regexer {
 public:
     explicit Regexer(const std::string& regex);
     std::vector<Match> search(const std::string& searchString) const;
+
+    /**
+     * Iterate over the matches in a string without copying any of it, the string must outlive the range
+     */
+    MatchRange matches(std::string_view searchString) const;
 };
 #endif //SLINGER_REGEXER_H
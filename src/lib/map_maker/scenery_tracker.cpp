@@ -0,0 +1,91 @@
+//
+// Created by derek on 19/11/20.
+//
+
+#include "scenery_tracker.h"
+
+#include <algorithm>
+
+#include "map_maker.h"
+#include "mesh_cache.h"
+
+SceneryTracker::SceneryTracker(entt::registry &registry, Physics &physics, MapShapeBuilder &builder):
+    registry_(registry),
+    physics_(physics),
+    builder_(builder)
+{
+
+}
+
+std::vector<entt::entity> SceneryTracker::add(const LevelData &level) {
+    std::vector<entt::entity> entities;
+
+    tracking_ = &entities;
+    registry_.on_construct<BodyPtr>().connect<&SceneryTracker::track>(this);
+    registry_.on_construct<FixtureInfoPtr>().connect<&SceneryTracker::track>(this);
+    registry_.on_construct<Drawable>().connect<&SceneryTracker::track>(this);
+
+    auto stopTracking = [this]() {
+        registry_.on_construct<BodyPtr>().disconnect<&SceneryTracker::track>(this);
+        registry_.on_construct<FixtureInfoPtr>().disconnect<&SceneryTracker::track>(this);
+        registry_.on_construct<Drawable>().disconnect<&SceneryTracker::track>(this);
+        tracking_ = nullptr;
+    };
+
+    try {
+        builder_.makeScenery(level);
+    } catch (...) {
+        stopTracking();
+        throw;
+    }
+
+    stopTracking();
+
+    std::sort(entities.begin(), entities.end());
+    entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+
+    return entities;
+}
+
+void SceneryTracker::remove(std::vector<entt::entity> &entities) {
+    // Bodies go first so that contacts ending can still look up their entities
+    for (auto entity : entities) {
+        physics_.destroyBody(entity);
+    }
+
+    for (auto entity : entities) {
+        if (registry_.valid(entity)) {
+            registry_.destroy(entity);
+        }
+    }
+
+    entities.clear();
+    entities.shrink_to_fit();
+}
+
+bool SceneryTracker::isHeld(const std::vector<entt::entity> &entities) const {
+    bool held = false;
+
+    registry_.view<HoldingRope>().each([this, &entities, &held](const auto entity, const HoldingRope &holding) {
+        auto *joint = registry_.try_get<JointPtr>(holding.rope);
+        if (!joint || !*joint) {
+            return;
+        }
+
+        for (auto scenery : entities) {
+            auto *body = registry_.try_get<BodyPtr>(scenery);
+
+            if (body && ((*joint)->GetBodyA() == body->get() || (*joint)->GetBodyB() == body->get())) {
+                held = true;
+            }
+        }
+    });
+
+    return held;
+}
+
+void SceneryTracker::track(entt::registry &registry, entt::entity entity) {
+    if (tracking_) {
+        tracking_->push_back(entity);
+    }
+}
@@ -0,0 +1,53 @@
+//
+// Created by derek on 19/11/20.
+//
+
+#ifndef SLINGER_SCENERY_TRACKER_H
+#define SLINGER_SCENERY_TRACKER_H
+
+#include <vector>
+
+#include <entt/entity/registry.hpp>
+
+#include "level_data.h"
+#include "physics.h"
+
+class MapShapeBuilder;
+
+/**
+ * Adds level data to the world while recording every entity it creates, so that part of a
+ * level can be taken out of the world again without touching the rest of it
+ */
+class SceneryTracker {
+    entt::registry& registry_;
+    Physics& physics_;
+    MapShapeBuilder& builder_;
+
+    // Where entities created while scenery is added are recorded
+    std::vector<entt::entity>* tracking_ = nullptr;
+
+public:
+    SceneryTracker(entt::registry& registry, Physics& physics, MapShapeBuilder& builder);
+
+    /**
+     * Add the scenery of a level to the world
+     * @return every entity that was created, sorted
+     */
+    std::vector<entt::entity> add(const LevelData& level);
+
+    /**
+     * Destroy entities returned by add, along with their bodies
+     */
+    void remove(std::vector<entt::entity>& entities);
+
+    /**
+     * Whether a rope is attached to any of the entities, removing them would leave it dangling
+     */
+    [[nodiscard]] bool isHeld(const std::vector<entt::entity>& entities) const;
+
+private:
+    void track(entt::registry& registry, entt::entity entity);
+};
+
+
+#endif //SLINGER_SCENERY_TRACKER_H
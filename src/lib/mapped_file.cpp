@@ -0,0 +1,140 @@
+//
+// Created by derek on 14/11/20.
+//
+
+#include "mapped_file.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string &path) {
+    file_ = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+
+    if (file_ == INVALID_HANDLE_VALUE) {
+        file_ = nullptr;
+        throw std::runtime_error("Could not open file to map: " + path);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size)) {
+        close();
+        throw std::runtime_error("Could not get size of file to map: " + path);
+    }
+
+    size_ = (std::size_t) size.QuadPart;
+
+    // Empty files can't be mapped, leave them with no data
+    if (size_ == 0) {
+        return;
+    }
+
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) {
+        close();
+        throw std::runtime_error("Could not map file: " + path);
+    }
+
+    data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        close();
+        throw std::runtime_error("Could not map file: " + path);
+    }
+}
+
+void MappedFile::close() {
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+
+    if (mapping_) {
+        CloseHandle(mapping_);
+    }
+
+    if (file_) {
+        CloseHandle(file_);
+    }
+
+    data_ = nullptr;
+    mapping_ = nullptr;
+    file_ = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &path) {
+    file_ = open(path.c_str(), O_RDONLY);
+
+    if (file_ < 0) {
+        throw std::runtime_error("Could not open file to map: " + path);
+    }
+
+    struct stat info {};
+    if (fstat(file_, &info) != 0) {
+        close();
+        throw std::runtime_error("Could not get size of file to map: " + path);
+    }
+
+    size_ = (std::size_t) info.st_size;
+
+    // Empty files can't be mapped, leave them with no data
+    if (size_ == 0) {
+        return;
+    }
+
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_, 0);
+    if (data == MAP_FAILED) {
+        close();
+        throw std::runtime_error("Could not map file: " + path);
+    }
+
+    // The whole file is read front to back so let the kernel read ahead
+    madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(data);
+}
+
+void MappedFile::close() {
+    if (data_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+
+    if (file_ >= 0) {
+        ::close(file_);
+    }
+
+    data_ = nullptr;
+    file_ = -1;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+const char *MappedFile::data() const {
+    return data_;
+}
+
+std::size_t MappedFile::size() const {
+    return size_;
+}
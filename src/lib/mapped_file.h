@@ -0,0 +1,40 @@
+//
+// Created by derek on 14/11/20.
+//
+
+#ifndef SLINGER_MAPPED_FILE_H
+#define SLINGER_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A read only view of a whole file mapped into memory, the mapping is released on destruction
+ */
+class MappedFile {
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int file_ = -1;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const char* data() const;
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    void close();
+};
+
+
+#endif //SLINGER_MAPPED_FILE_H
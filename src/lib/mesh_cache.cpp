@@ -0,0 +1,378 @@
+//
+// Created by derek on 08/11/20.
+//
+
+#include "mesh_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "mesh_shape.h"
+
+namespace {
+    sf::Vector2f normal(const sf::Vector2f &p1, const sf::Vector2f &p2) {
+        sf::Vector2f normal(p1.y - p2.y, p2.x - p1.x);
+        float length = std::sqrt(normal.x * normal.x + normal.y * normal.y);
+
+        return length != 0.f ? normal / length : normal;
+    }
+
+    float dot(const sf::Vector2f &lhs, const sf::Vector2f &rhs) {
+        return lhs.x * rhs.x + lhs.y * rhs.y;
+    }
+
+    // Marks a handle whose mesh has been freed, so later entries for it are skipped
+    const std::uint64_t FREED = std::numeric_limits<std::uint64_t>::max();
+
+    template <class T>
+    void hashBytes(std::size_t &hash, const T &value) {
+        const auto *bytes = reinterpret_cast<const unsigned char *>(&value);
+
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+}
+
+sf::Transform Drawable::getTransform() const {
+    float angle = -rotation * 3.141592654f / 180.f;
+    float cosine = std::cos(angle);
+    float sine = std::sin(angle);
+    float sxc = scale.x * cosine;
+    float syc = scale.y * cosine;
+    float sxs = scale.x * sine;
+    float sys = scale.y * sine;
+    float tx = -origin.x * sxc - origin.y * sys + position.x;
+    float ty = origin.x * sxs - origin.y * syc + position.y;
+
+    return sf::Transform(
+        sxc, sys, tx,
+        -sxs, syc, ty,
+        0.f, 0.f, 1.f
+    );
+}
+
+const std::size_t MeshCache::SEGMENT_SIZE = 1024;
+const std::size_t MeshCache::MAX_SEGMENTS = 4096;
+
+MeshCache::MeshCache() {
+    segments_.reserve(MAX_SEGMENTS);
+}
+
+MeshHandle MeshCache::add(RenderMesh mesh) {
+    auto key = hash(mesh);
+
+    auto [begin, end] = lookup_.equal_range(key);
+    for (auto it = begin; it != end; it++) {
+        if (equal(at(it->second), mesh)) {
+            uses_[it->second]++;
+            return it->second;
+        }
+    }
+
+    auto handle = allocate();
+    at(handle) = std::move(mesh);
+    uses_[handle] = 1;
+    lookup_.emplace(key, handle);
+
+    // Published once the mesh is in place, a reused handle was counted when it was first made
+    if (handle == size_.load(std::memory_order_relaxed)) {
+        size_.store(handle + 1, std::memory_order_release);
+    }
+
+    return handle;
+}
+
+MeshHandle MeshCache::add(const sf::Shape &shape) {
+    std::vector<sf::Vector2f> points;
+    for (std::size_t i = 0; i < shape.getPointCount(); i++) {
+        auto point = shape.getPoint(i);
+
+        if (points.empty() || points.back() != point) {
+            points.push_back(point);
+        }
+    }
+
+    while (points.size() > 1 && points.front() == points.back()) {
+        points.pop_back();
+    }
+
+    RenderMesh mesh;
+
+    // Mesh shapes have already been triangulated, anything else sfml offers is convex
+    const auto *meshShape = dynamic_cast<const MeshShape *>(&shape);
+
+    // A mesh can cover separate islands that its outline points don't reach
+    auto extent = points;
+    if (meshShape) {
+        const auto &vertices = meshShape->getMesh().vertices;
+        extent.insert(extent.end(), vertices.begin(), vertices.end());
+    }
+
+    if (!extent.empty()) {
+        mesh.bounds = sf::FloatRect(extent[0].x, extent[0].y, 0, 0);
+        for (const auto &point : extent) {
+            auto right = std::max(mesh.bounds.left + mesh.bounds.width, point.x);
+            auto bottom = std::max(mesh.bounds.top + mesh.bounds.height, point.y);
+            mesh.bounds.left = std::min(mesh.bounds.left, point.x);
+            mesh.bounds.top = std::min(mesh.bounds.top, point.y);
+            mesh.bounds.width = right - mesh.bounds.left;
+            mesh.bounds.height = bottom - mesh.bounds.top;
+        }
+    }
+
+    if (meshShape) {
+        addFill(mesh, shape.getFillColor(), meshShape->getMesh().vertices, meshShape->getMesh().indices);
+    } else {
+        std::vector<std::uint32_t> fan;
+        for (std::uint32_t i = 1; i + 1 < points.size(); i++) {
+            fan.insert(fan.end(), { 0, i, i + 1 });
+        }
+
+        addFill(mesh, shape.getFillColor(), points, fan);
+    }
+
+    if (shape.getOutlineThickness() != 0.f && points.size() > 2) {
+        addOutline(mesh, shape, points);
+    }
+
+    // Filled in before the mesh is published, it never changes once another thread can see it
+    if (meshShape) {
+        for (const auto &detail : meshShape->getDetailLevels()) {
+            // Share the bounds of the full mesh so textures line up between levels
+            RenderMesh simplified;
+            simplified.bounds = mesh.bounds;
+            addFill(simplified, shape.getFillColor(), detail.mesh.vertices, detail.mesh.indices);
+
+            mesh.detailLevels.push_back(DetailLevel { detail.tolerance, add(std::move(simplified)) });
+        }
+    }
+
+    return add(std::move(mesh));
+}
+
+Drawable MeshCache::createDrawable(const sf::Shape &shape, int zIndex) {
+    Drawable drawable;
+    drawable.mesh = add(shape);
+    drawable.zIndex = zIndex;
+    drawable.position = shape.getPosition();
+    drawable.origin = shape.getOrigin();
+    drawable.scale = shape.getScale();
+    drawable.rotation = shape.getRotation();
+    drawable.texture = shape.getTexture();
+    drawable.textureRect = shape.getTextureRect();
+
+    return drawable;
+}
+
+void MeshCache::release(MeshHandle handle) {
+    if (uses_.at(handle) == 0) {
+        throw std::runtime_error("Mesh " + std::to_string(handle) + " released more often than it was added");
+    }
+
+    // Each use of a mesh added its detail levels again, so they lose a use along with it
+    for (const auto &detail : at(handle).detailLevels) {
+        release(detail.mesh);
+    }
+
+    if (--uses_[handle] == 0) {
+        releasedIn_[handle] = frame_;
+        released_.push_back(Released { handle, frame_ });
+    }
+}
+
+std::uint64_t MeshCache::nextFrame() {
+    return ++frame_;
+}
+
+void MeshCache::collect(std::uint64_t drawing) {
+    // Released in frame order, so everything after the first that is too new is too
+    while (!released_.empty() && released_.front().frame < drawing) {
+        auto [handle, frame] = released_.front();
+        released_.pop_front();
+
+        // Added again since, or released again later and left for that entry
+        if (uses_[handle] != 0 || releasedIn_[handle] != frame) {
+            continue;
+        }
+
+        auto [begin, end] = lookup_.equal_range(hash(at(handle)));
+        for (auto it = begin; it != end; it++) {
+            if (it->second == handle) {
+                lookup_.erase(it);
+                break;
+            }
+        }
+
+        at(handle) = RenderMesh();
+        releasedIn_[handle] = FREED;
+        free_.push_back(handle);
+    }
+}
+
+const RenderMesh &MeshCache::get(MeshHandle handle) const {
+    if (handle >= size_.load(std::memory_order_acquire)) {
+        throw std::out_of_range("No mesh with handle " + std::to_string(handle));
+    }
+
+    return at(handle);
+}
+
+std::size_t MeshCache::size() const {
+    return size_.load(std::memory_order_acquire) - free_.size();
+}
+
+MeshHandle MeshCache::allocate() {
+    if (!free_.empty()) {
+        auto handle = free_.back();
+        free_.pop_back();
+
+        return handle;
+    }
+
+    auto handle = (MeshHandle) size_.load(std::memory_order_relaxed);
+    if (handle % SEGMENT_SIZE == 0) {
+        if (segments_.size() == MAX_SEGMENTS) {
+            throw std::runtime_error("Mesh cache is full");
+        }
+
+        segments_.push_back(std::make_unique<RenderMesh[]>(SEGMENT_SIZE));
+    }
+
+    uses_.push_back(0);
+    releasedIn_.push_back(0);
+
+    return handle;
+}
+
+RenderMesh &MeshCache::at(MeshHandle handle) {
+    return segments_[handle / SEGMENT_SIZE][handle % SEGMENT_SIZE];
+}
+
+const RenderMesh &MeshCache::at(MeshHandle handle) const {
+    return segments_[handle / SEGMENT_SIZE][handle % SEGMENT_SIZE];
+}
+
+std::size_t MeshCache::hash(const RenderMesh &mesh) {
+    std::size_t hash = 14695981039346656037ull;
+
+    for (const auto &vertex : mesh.vertices) {
+        hashBytes(hash, vertex.position.x);
+        hashBytes(hash, vertex.position.y);
+        hashBytes(hash, vertex.color.toInteger());
+        hashBytes(hash, vertex.texCoords.x);
+        hashBytes(hash, vertex.texCoords.y);
+    }
+
+    for (auto index : mesh.indices) {
+        hashBytes(hash, index);
+    }
+
+    for (const auto &detail : mesh.detailLevels) {
+        hashBytes(hash, detail.tolerance);
+        hashBytes(hash, detail.mesh);
+    }
+
+    return hash;
+}
+
+bool MeshCache::equal(const RenderMesh &lhs, const RenderMesh &rhs) {
+    if (lhs.vertices.size() != rhs.vertices.size() || lhs.indices != rhs.indices) {
+        return false;
+    }
+
+    // The same geometry simplified differently has to be drawn differently when far away
+    if (lhs.detailLevels.size() != rhs.detailLevels.size()) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < lhs.detailLevels.size(); i++) {
+        const auto &a = lhs.detailLevels[i];
+        const auto &b = rhs.detailLevels[i];
+
+        if (a.tolerance != b.tolerance || a.mesh != b.mesh) {
+            return false;
+        }
+    }
+
+    for (std::size_t i = 0; i < lhs.vertices.size(); i++) {
+        const auto &a = lhs.vertices[i];
+        const auto &b = rhs.vertices[i];
+
+        if (a.position != b.position || a.color != b.color || a.texCoords != b.texCoords) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MeshCache::addFill(
+    RenderMesh &mesh,
+    const sf::Color &colour,
+    const std::vector<sf::Vector2f> &positions,
+    const std::vector<std::uint32_t> &indices
+) {
+    const auto &bounds = mesh.bounds;
+    const auto start = (std::uint32_t) mesh.vertices.size();
+
+    for (const auto &position : positions) {
+        sf::Vector2f texCoords(
+            bounds.width > 0 ? (position.x - bounds.left) / bounds.width : 0,
+            bounds.height > 0 ? (position.y - bounds.top) / bounds.height : 0
+        );
+
+        mesh.vertices.emplace_back(position, colour, texCoords);
+    }
+
+    for (auto index : indices) {
+        mesh.indices.push_back(start + index);
+    }
+}
+
+void MeshCache::addOutline(RenderMesh &mesh, const sf::Shape &shape, const std::vector<sf::Vector2f> &points) {
+    const auto start = (std::uint32_t) mesh.vertices.size();
+    const auto count = (std::uint32_t) points.size();
+    const sf::Vector2f centre(
+        mesh.bounds.left + mesh.bounds.width / 2.f,
+        mesh.bounds.top + mesh.bounds.height / 2.f
+    );
+
+    // Extrude each corner along the average of its edge normals, the same way sfml does
+    for (std::uint32_t i = 0; i < count; i++) {
+        const auto &p0 = points[(i + count - 1) % count];
+        const auto &p1 = points[i];
+        const auto &p2 = points[(i + 1) % count];
+
+        auto n1 = normal(p0, p1);
+        auto n2 = normal(p1, p2);
+
+        if (dot(n1, centre - p1) > 0) {
+            n1 = -n1;
+        }
+
+        if (dot(n2, centre - p1) > 0) {
+            n2 = -n2;
+        }
+
+        float factor = 1.f + dot(n1, n2);
+        auto extruded = p1 + (n1 + n2) / factor * shape.getOutlineThickness();
+
+        mesh.vertices.emplace_back(p1, shape.getOutlineColor());
+        mesh.vertices.emplace_back(extruded, shape.getOutlineColor());
+    }
+
+    for (std::uint32_t i = 0; i < count; i++) {
+        auto inner = start + i * 2;
+        auto nextInner = start + ((i + 1) % count) * 2;
+
+        mesh.indices.insert(mesh.indices.end(), {
+            inner, inner + 1, nextInner,
+            inner + 1, nextInner + 1, nextInner
+        });
+    }
+}
@@ -0,0 +1,154 @@
+//
+// Created by derek on 08/11/20.
+//
+
+#ifndef SLINGER_MESH_CACHE_H
+#define SLINGER_MESH_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Shape.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include "triangulator.h"
+
+using MeshHandle = std::uint32_t;
+
+/**
+ * A simplified mesh along with the furthest any removed point is from it
+ */
+struct DetailLevel {
+    float tolerance;
+    MeshHandle mesh;
+};
+
+/**
+ * Triangulated geometry in local space, texture coordinates are normalised across the fill
+ * bounds so the same geometry can be used with any texture rect
+ */
+struct RenderMesh {
+    std::vector<sf::Vertex> vertices;
+    std::vector<std::uint32_t> indices;
+    sf::FloatRect bounds;
+
+    // Simplified versions of this mesh from least to most simplified
+    std::vector<DetailLevel> detailLevels;
+};
+
+/**
+ * A compact handle to shared geometry along with everything needed to place it
+ */
+struct Drawable {
+    MeshHandle mesh = 0;
+    int zIndex = 0;
+    sf::Vector2f position;
+    sf::Vector2f origin;
+    sf::Vector2f scale {1, 1};
+    float rotation = 0;
+    sf::Color color = sf::Color::White;
+    const sf::Texture* texture = nullptr;
+    sf::IntRect textureRect;
+
+    [[nodiscard]] sf::Transform getTransform() const;
+};
+
+/**
+ * Stores every mesh used by drawables once, identical shapes share the same geometry.
+ *
+ * Meshes are only added and released from one thread, but once a handle has been handed out
+ * its mesh never moves or changes while it is in use, so another thread can draw it while more
+ * are being added. A mesh nothing uses any more is only freed, and its handle reused, once the
+ * thread drawing has moved past every frame that could have held it.
+ */
+class MeshCache {
+    static const std::size_t SEGMENT_SIZE;
+    static const std::size_t MAX_SEGMENTS;
+
+    struct Released {
+        MeshHandle handle;
+        std::uint64_t frame;
+    };
+
+    // Fixed size blocks that are never reallocated, the list of them is reserved up front
+    std::vector<std::unique_ptr<RenderMesh[]>> segments_;
+    std::atomic<std::size_t> size_ {0};
+    std::unordered_multimap<std::size_t, MeshHandle> lookup_;
+
+    // Only touched by the thread adding meshes
+    std::vector<std::uint32_t> uses_;
+    std::vector<std::uint64_t> releasedIn_;
+    std::deque<Released> released_;
+    std::vector<MeshHandle> free_;
+    std::uint64_t frame_ = 0;
+
+public:
+    MeshCache();
+
+    /**
+     * Add a mesh to the cache, returning the handle of an identical mesh if there is one. Each
+     * add is a use of the mesh that has to be released once it is no longer drawn.
+     */
+    MeshHandle add(RenderMesh mesh);
+
+    /**
+     * Build the fill and outline geometry of a shape and add it to the cache
+     */
+    MeshHandle add(const sf::Shape& shape);
+
+    /**
+     * Make a drawable from a shape, copying its transform and texture
+     */
+    Drawable createDrawable(const sf::Shape& shape, int zIndex);
+
+    /**
+     * Give up a use of a mesh and of its detail levels. Adding an identical mesh before it is
+     * collected brings it back.
+     */
+    void release(MeshHandle handle);
+
+    /**
+     * Start capturing a frame, meshes released from here on may still be drawn in it
+     * @return the number of the frame
+     */
+    std::uint64_t nextFrame();
+
+    /**
+     * Free the meshes nothing has used since before the given frame was captured
+     * @param drawing the oldest frame the drawing thread may still be reading
+     */
+    void collect(std::uint64_t drawing);
+
+    [[nodiscard]] const RenderMesh& get(MeshHandle handle) const;
+
+    /**
+     * How many meshes are stored, only from the thread adding them
+     */
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    MeshHandle allocate();
+
+    RenderMesh& at(MeshHandle handle);
+    [[nodiscard]] const RenderMesh& at(MeshHandle handle) const;
+
+    static std::size_t hash(const RenderMesh& mesh);
+    static bool equal(const RenderMesh& lhs, const RenderMesh& rhs);
+    static void addFill(
+        RenderMesh& mesh,
+        const sf::Color& colour,
+        const std::vector<sf::Vector2f>& positions,
+        const std::vector<std::uint32_t>& indices
+    );
+    static void addOutline(RenderMesh& mesh, const sf::Shape& shape, const std::vector<sf::Vector2f>& points);
+};
+
+
+#endif //SLINGER_MESH_CACHE_H
@@ -0,0 +1,68 @@
+//
+// Created by derek on 05/11/20.
+//
+
+#include "mesh_shape.h"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+
+MeshShape::MeshShape(std::vector<sf::Vector2f> outline, Mesh mesh) :
+    outline_(std::move(outline)),
+    mesh_(std::move(mesh)),
+    vertices_(sf::Triangles)
+{
+    update();
+}
+
+std::size_t MeshShape::getPointCount() const {
+    return outline_.size();
+}
+
+sf::Vector2f MeshShape::getPoint(std::size_t index) const {
+    return outline_.at(index);
+}
+
+const Mesh &MeshShape::getMesh() const {
+    return mesh_;
+}
+
+void MeshShape::addDetailLevel(float tolerance, Mesh mesh) {
+    detailLevels_.push_back(DetailMesh { tolerance, std::move(mesh) });
+}
+
+const std::vector<DetailMesh> &MeshShape::getDetailLevels() const {
+    return detailLevels_;
+}
+
+void MeshShape::draw(sf::RenderTarget &target, sf::RenderStates states) const {
+    if (!built_ || vertexColour_ != getFillColor() || vertexTextureRect_ != getTextureRect()) {
+        buildVertices();
+    }
+
+    states.transform *= getTransform();
+    states.texture = getTexture();
+    target.draw(vertices_, states);
+}
+
+void MeshShape::buildVertices() const {
+    const auto bounds = getLocalBounds();
+    const auto rect = getTextureRect();
+
+    vertices_.resize(mesh_.indices.size());
+
+    for (std::size_t i = 0; i < mesh_.indices.size(); i++) {
+        const auto &point = mesh_.vertices[mesh_.indices[i]];
+
+        // Map the point across the texture rect the same way sf::Shape does for its fan
+        float u = bounds.width > 0 ? (point.x - bounds.left) / bounds.width : 0;
+        float v = bounds.height > 0 ? (point.y - bounds.top) / bounds.height : 0;
+
+        vertices_[i].position = point;
+        vertices_[i].color = getFillColor();
+        vertices_[i].texCoords = sf::Vector2f(rect.left + rect.width * u, rect.top + rect.height * v);
+    }
+
+    vertexColour_ = getFillColor();
+    vertexTextureRect_ = getTextureRect();
+    built_ = true;
+}
@@ -0,0 +1,59 @@
+//
+// Created by derek on 05/11/20.
+//
+
+#ifndef SLINGER_MESH_SHAPE_H
+#define SLINGER_MESH_SHAPE_H
+
+#include <vector>
+
+#include <SFML/Graphics/Shape.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include "triangulator.h"
+
+/**
+ * A simplified copy of a mesh, used in place of the full mesh when it is drawn small enough
+ * that the removed detail would not be visible
+ */
+struct DetailMesh {
+    float tolerance;
+    Mesh mesh;
+};
+
+/**
+ * A shape that fills itself from a triangulated mesh rather than a triangle fan, so that
+ * concave polygons and polygons with holes are drawn correctly. The outline points are
+ * kept for bounds and physics, but outlines are not drawn.
+ */
+class MeshShape : public sf::Shape {
+    std::vector<sf::Vector2f> outline_;
+    Mesh mesh_;
+    std::vector<DetailMesh> detailLevels_;
+
+    // The mesh is only rebuilt when the fill colour or texture rect changes
+    mutable sf::VertexArray vertices_;
+    mutable sf::Color vertexColour_;
+    mutable sf::IntRect vertexTextureRect_;
+    mutable bool built_ = false;
+
+public:
+    explicit MeshShape(std::vector<sf::Vector2f> outline, Mesh mesh);
+
+    [[nodiscard]] std::size_t getPointCount() const override;
+    [[nodiscard]] sf::Vector2f getPoint(std::size_t index) const override;
+    [[nodiscard]] const Mesh& getMesh() const;
+
+    /**
+     * Add a simplified version of the mesh, levels should be added from least to most simplified
+     */
+    void addDetailLevel(float tolerance, Mesh mesh);
+    [[nodiscard]] const std::vector<DetailMesh>& getDetailLevels() const;
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void buildVertices() const;
+};
+
+
+#endif //SLINGER_MESH_SHAPE_H
@@ -0,0 +1,210 @@
+//
+// Created by derek on 24/11/20.
+//
+
+#include "metrics.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+const float MetricsExporter::INTERVAL = 1.f;
+const std::string MetricsExporter::PREFIX = "slinger_";
+
+double Metrics::Series::mean() const {
+    return count > 0 ? sum / (double) count : 0;
+}
+
+void Metrics::increment(std::string_view name, double by) {
+    auto &series = find(name, Kind::COUNTER);
+
+    series.count++;
+    series.sum += by;
+    series.total += by;
+    series.last = series.total;
+}
+
+void Metrics::sample(std::string_view name, double value) {
+    auto &series = find(name, Kind::GAUGE);
+
+    series.min = series.count > 0 ? std::min(series.min, value) : value;
+    series.max = series.count > 0 ? std::max(series.max, value) : value;
+    series.count++;
+    series.sum += value;
+    series.last = value;
+}
+
+void Metrics::reset() {
+    for (auto &[name, series] : series_) {
+        series.count = 0;
+        series.sum = 0;
+        series.min = 0;
+        series.max = 0;
+    }
+}
+
+const Metrics::Series *Metrics::get(std::string_view name) const {
+    auto it = series_.find(name);
+
+    return it != series_.end() ? &it->second : nullptr;
+}
+
+const Metrics::SeriesMap &Metrics::getSeries() const {
+    return series_;
+}
+
+std::string Metrics::toMetricName(std::string_view text) {
+    std::string name;
+
+    for (char c : text) {
+        if (std::isalnum((unsigned char) c)) {
+            name += (char) std::tolower((unsigned char) c);
+        } else if (!name.empty() && name.back() != '_') {
+            name += '_';
+        }
+    }
+
+    while (!name.empty() && name.back() == '_') {
+        name.pop_back();
+    }
+
+    return name;
+}
+
+Metrics::Series &Metrics::find(std::string_view name, Kind kind) {
+    auto it = series_.find(name);
+
+    if (it == series_.end()) {
+        it = series_.emplace(std::string(name), Series { kind }).first;
+    } else if (it->second.kind != kind) {
+        throw std::runtime_error("Metric " + std::string(name) + " is already used as a different kind");
+    }
+
+    return it->second;
+}
+
+MetricsExporter::MetricsExporter(Metrics &metrics, std::string path, float interval) :
+    metrics_(metrics),
+    path_(std::move(path)),
+    format_(formatFor(path_)),
+    interval_(interval)
+{
+    if (format_ == Format::CSV) {
+        csv_.open(path_, std::ios::app);
+
+        if (!csv_) {
+            throw std::runtime_error("Unable to open metrics file " + path_);
+        }
+
+        if (csv_.tellp() == 0) {
+            writeCsvHeader(csv_);
+        }
+    }
+
+    metrics_.reset();
+}
+
+MetricsExporter::~MetricsExporter() {
+    flush();
+}
+
+void MetricsExporter::update(float delta) {
+    elapsed_ += delta;
+
+    if (elapsed_ >= interval_) {
+        flush();
+    }
+}
+
+void MetricsExporter::flush() {
+    elapsed_ = 0;
+
+    if (format_ == Format::CSV) {
+        writeCsv(csv_, metrics_, now());
+        csv_.flush();
+    } else {
+        // Write next to the file and swap it in so a collector never reads half of it
+        auto temporary = path_ + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::trunc);
+            writeOpenMetrics(out, metrics_);
+        }
+
+        std::remove(path_.c_str());
+        std::rename(temporary.c_str(), path_.c_str());
+    }
+
+    metrics_.reset();
+}
+
+MetricsExporter::Format MetricsExporter::formatFor(const std::string &path) {
+    const std::string extension = ".csv";
+
+    if (path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0) {
+        return Format::CSV;
+    }
+
+    return Format::OPEN_METRICS;
+}
+
+void MetricsExporter::writeCsvHeader(std::ostream &out) {
+    out << "timestamp,metric,type,count,sum,min,mean,max,total\n";
+}
+
+void MetricsExporter::writeCsv(std::ostream &out, const Metrics &metrics, double timestamp) {
+    std::ostringstream rows;
+    rows << std::fixed << std::setprecision(3);
+
+    for (const auto &[name, series] : metrics.getSeries()) {
+        rows << timestamp << ',' << name << ',';
+
+        if (series.kind == Metrics::Kind::COUNTER) {
+            rows << "counter," << series.count << ',' << series.sum << ",,,," << series.total << '\n';
+        } else if (series.count > 0) {
+            rows << "gauge," << series.count << ',' << series.sum << ',' << series.min << ','
+                 << series.mean() << ',' << series.max << ",\n";
+        } else {
+            rows << "gauge,0,,,,,\n";
+        }
+    }
+
+    out << rows.str();
+}
+
+void MetricsExporter::writeOpenMetrics(std::ostream &out, const Metrics &metrics) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(3);
+
+    for (const auto &[name, series] : metrics.getSeries()) {
+        auto family = PREFIX + name;
+
+        if (series.kind == Metrics::Kind::COUNTER) {
+            text << "# TYPE " << family << " counter\n";
+            text << family << "_total " << series.total << '\n';
+            continue;
+        }
+
+        // Gauges that weren't sampled this interval have nothing to report
+        if (series.count == 0) {
+            continue;
+        }
+
+        text << "# TYPE " << family << " gauge\n";
+        text << family << "{stat=\"min\"} " << series.min << '\n';
+        text << family << "{stat=\"mean\"} " << series.mean() << '\n';
+        text << family << "{stat=\"max\"} " << series.max << '\n';
+    }
+
+    text << "# EOF\n";
+    out << text.str();
+}
+
+double MetricsExporter::now() {
+    auto since = std::chrono::system_clock::now().time_since_epoch();
+
+    return std::chrono::duration<double>(since).count();
+}
@@ -0,0 +1,132 @@
+//
+// Created by derek on 24/11/20.
+//
+
+#ifndef SLINGER_METRICS_H
+#define SLINGER_METRICS_H
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * Engine counters and sampled values, aggregated over a reporting interval. Kept in the registry
+ * context so anything with the registry can add to them.
+ */
+class Metrics {
+public:
+    enum class Kind {
+        COUNTER,
+        GAUGE
+    };
+
+    struct Series {
+        Kind kind = Kind::GAUGE;
+
+        // Samples or increments since the interval started
+        std::uint64_t count = 0;
+        double sum = 0;
+        double min = 0;
+        double max = 0;
+        double last = 0;
+
+        // Counters keep adding up across intervals
+        double total = 0;
+
+        [[nodiscard]] double mean() const;
+    };
+
+    using SeriesMap = std::map<std::string, Series, std::less<>>;
+
+private:
+    SeriesMap series_;
+
+public:
+    /**
+     * Add to a counter, making it if this is the first time it has been counted
+     */
+    void increment(std::string_view name, double by = 1);
+
+    /**
+     * Record a value of a gauge, such as how long part of a step took
+     */
+    void sample(std::string_view name, double value);
+
+    /**
+     * Start a new interval, counters keep their totals
+     */
+    void reset();
+
+    [[nodiscard]] const Series* get(std::string_view name) const;
+    [[nodiscard]] const SeriesMap& getSeries() const;
+
+    /**
+     * Turn something like a trace zone name into a lower case metric name
+     */
+    static std::string toMetricName(std::string_view text);
+
+private:
+    Series& find(std::string_view name, Kind kind);
+};
+
+/**
+ * Periodically writes metrics to a local file so long runs leave a time series behind. CSV
+ * files get a row per metric appended every interval, anything else is rewritten with the
+ * latest interval as OpenMetrics text for a textfile collector to pick up.
+ */
+class MetricsExporter {
+public:
+    enum class Format {
+        CSV,
+        OPEN_METRICS
+    };
+
+    static const float INTERVAL;
+    static const std::string PREFIX;
+
+private:
+    Metrics& metrics_;
+    std::string path_;
+    Format format_;
+    float interval_;
+    float elapsed_ = 0;
+    std::ofstream csv_;
+
+public:
+    /**
+     * @param path where to write, the format is picked from its extension
+     * @param interval how many seconds of metrics to aggregate into each write
+     */
+    MetricsExporter(Metrics& metrics, std::string path, float interval = INTERVAL);
+    ~MetricsExporter();
+
+    /**
+     * Write the current interval once enough time has passed, then start a new one
+     */
+    void update(float delta);
+
+    /**
+     * Write whatever has been gathered so far and start a new interval
+     */
+    void flush();
+
+    static Format formatFor(const std::string& path);
+
+    static void writeCsvHeader(std::ostream& out);
+    static void writeCsv(std::ostream& out, const Metrics& metrics, double timestamp);
+
+    /**
+     * Samples are left without timestamps, the textfile collector rejects any file that has them
+     * and stamps them with the time it scrapes
+     */
+    static void writeOpenMetrics(std::ostream& out, const Metrics& metrics);
+
+private:
+    static double now();
+};
+
+
+#endif //SLINGER_METRICS_H
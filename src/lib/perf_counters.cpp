@@ -0,0 +1,163 @@
+//
+// Created by derek on 26/11/20.
+//
+
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+
+#include "perf_counters.h"
+
+#include <spdlog/spdlog.h>
+
+#if defined(SLINGER_PERF_COUNTERS) && defined(__linux__)
+#define SLINGER_PERF_EVENTS
+
+#include <cerrno>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const std::array<const char*, (std::size_t) PerfCounters::Event::COUNT> PerfCounters::EVENT_NAMES = {
+    "cycles",
+    "instructions",
+    "cache_misses",
+    "branch_misses"
+};
+
+#ifdef SLINGER_PERF_EVENTS
+namespace {
+    const std::array<std::uint64_t, (std::size_t) PerfCounters::Event::COUNT> CONFIGS = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    int openCounter(std::uint64_t config, int leader) {
+        perf_event_attr attr {};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // The leader holds the whole group back until every counter has joined it
+        attr.disabled = leader == -1;
+
+        return (int) syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+    }
+}
+#endif
+
+PerfCounters::PerfCounters() {
+    descriptors_.fill(-1);
+
+#ifdef SLINGER_PERF_EVENTS
+    auto leader = openCounter(CONFIGS[0], -1);
+
+    if (leader == -1) {
+        error_ = std::strerror(errno);
+
+        if (errno == EACCES || errno == EPERM) {
+            error_ += ", lowering /proc/sys/kernel/perf_event_paranoid allows them";
+        } else if (errno == ENOENT || errno == EOPNOTSUPP) {
+            error_ += ", the processor or virtual machine doesn't expose them";
+        }
+
+        SPDLOG_LOGGER_WARN(log_, "Hardware counters are unavailable: {}", error_);
+        return;
+    }
+
+    descriptors_[0] = leader;
+
+    for (std::size_t i = 1; i < descriptors_.size(); i++) {
+        descriptors_[i] = openCounter(CONFIGS[i], leader);
+
+        if (descriptors_[i] == -1) {
+            SPDLOG_LOGGER_WARN(log_, "Not counting {}: {}", EVENT_NAMES[i], std::strerror(errno));
+        }
+    }
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+    error_ = "Hardware counters need a Linux build with SLINGER_PERF_COUNTERS";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef SLINGER_PERF_EVENTS
+    for (auto descriptor : descriptors_) {
+        if (descriptor != -1) {
+            close(descriptor);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::isAvailable() const {
+    return descriptors_[0] != -1;
+}
+
+bool PerfCounters::isCounting(Event event) const {
+    return descriptors_[(std::size_t) event] != -1;
+}
+
+const std::string &PerfCounters::getError() const {
+    return error_;
+}
+
+PerfCounters::Counts PerfCounters::read() const {
+    Counts counts {};
+
+#ifdef SLINGER_PERF_EVENTS
+    if (!isAvailable()) {
+        return counts;
+    }
+
+    // The number of counters, how long the group was enabled and running, then each counter
+    // in the order they joined
+    std::array<std::uint64_t, 3 + (std::size_t) Event::COUNT> values {};
+    if (::read(descriptors_[0], values.data(), sizeof(values)) <= 0) {
+        return counts;
+    }
+
+    auto enabled = values[1];
+    auto running = values[2];
+    std::size_t next = 3;
+
+    for (std::size_t i = 0; i < descriptors_.size() && next < 3 + values[0]; i++) {
+        if (descriptors_[i] == -1) {
+            continue;
+        }
+
+        auto value = values[next++];
+
+        // Estimate the full count when the counters only had the hardware some of the time
+        if (running > 0 && running < enabled) {
+            value = (std::uint64_t) ((double) value * (double) enabled / (double) running);
+        }
+
+        counts[i] = value;
+    }
+#endif
+
+    return counts;
+}
+
+PerfCounters::Counts PerfCounters::lap() {
+    auto counts = read();
+    Counts lap {};
+
+    // Scaled counts are estimates and can go backwards slightly
+    for (std::size_t i = 0; i < counts.size(); i++) {
+        lap[i] = counts[i] > last_[i] ? counts[i] - last_[i] : 0;
+    }
+
+    last_ = counts;
+    return lap;
+}
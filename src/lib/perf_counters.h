@@ -0,0 +1,76 @@
+//
+// Created by derek on 26/11/20.
+//
+
+#ifndef SLINGER_PERF_COUNTERS_H
+#define SLINGER_PERF_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "logging.h"
+
+/**
+ * Hardware cycle, instruction, cache miss and branch miss counters for the thread that made
+ * them, read through perf_event_open. Only built on Linux with SLINGER_PERF_COUNTERS, and the
+ * kernel can refuse them, in which case every reading is zero and getError says why.
+ */
+class PerfCounters {
+public:
+    enum class Event : std::size_t {
+        CYCLES,
+        INSTRUCTIONS,
+        CACHE_MISSES,
+        BRANCH_MISSES,
+        COUNT
+    };
+
+    using Counts = std::array<std::uint64_t, (std::size_t) Event::COUNT>;
+
+    static const std::array<const char*, (std::size_t) Event::COUNT> EVENT_NAMES;
+
+private:
+    // The first counter leads the group so they're all started, stopped and read together
+    std::array<int, (std::size_t) Event::COUNT> descriptors_;
+    Counts last_ {};
+    std::string error_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::RENDER);
+
+public:
+    /**
+     * Start counting on the calling thread
+     */
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    [[nodiscard]] bool isAvailable() const;
+
+    /**
+     * Whether a single event is being counted, some are missing on virtual machines
+     */
+    [[nodiscard]] bool isCounting(Event event) const;
+
+    /**
+     * Why the counters aren't available, empty if they are
+     */
+    [[nodiscard]] const std::string& getError() const;
+
+    /**
+     * Everything counted since the counters were made, scaled up if the kernel had to share
+     * the hardware with other counters
+     */
+    [[nodiscard]] Counts read() const;
+
+    /**
+     * What was counted since the last lap
+     */
+    Counts lap();
+};
+
+
+#endif //SLINGER_PERF_COUNTERS_H
@@ -11,6 +11,10 @@
 #include "illustrator.h"
 #include "physics.h"
 #include "misc_components.h"
+#include "mesh_shape.h"
+#include "metrics.h"
+#include "simplifier.h"
+#include "tracer.h"
 
 
 Physics::Physics(entt::registry &registry, entt::dispatcher &dispatcher) :
@@ -28,21 +32,37 @@ Physics::Physics(entt::registry &registry, entt::dispatcher &dispatcher) :
 const float Physics::TIME_STEP = 1 / 120.f;
 
 void Physics::handlePhysics(entt::registry &registry, float delta, const sf::Vector2f &mousePos) {
-    world_.Step(TIME_STEP, 30, 15);
+    SLINGER_TRACE("Physics::handlePhysics");
 
+    step();
+    sync(registry, delta, mousePos);
+}
+
+void Physics::step() {
+    {
+        SLINGER_TRACE("b2World::Step");
+        world_.Step(TIME_STEP, 30, 15);
+    }
+
+    sampleMetrics();
+
+    SLINGER_TRACE("Physics::dispatch");
     dispatcher_.update();
+}
 
+void Physics::sync(entt::registry &registry, float delta, const sf::Vector2f &mousePos) {
+    SLINGER_TRACE("Physics::sync");
     registry.view<FixtureInfoPtr>().each(
         [delta, &registry, this](const auto entity, const FixtureInfoPtr &fixture) {
             b2Body *body = fixture->value->GetBody();
 
             if (Drawable *drawable = registry.try_get<Drawable>(entity)) {
-                (*drawable).value->setPosition(
+                drawable->position = sf::Vector2f(
                     body->GetPosition().x,
                     body->GetPosition().y
                 );
 
-                (*drawable).value->setRotation((body->GetAngle() * 180.f / 3.145f) + fixture->angleOffset);
+                drawable->rotation = (body->GetAngle() * 180.f / 3.145f) + fixture->angleOffset;
             }
         }
     );
@@ -80,15 +100,15 @@ void Physics::handlePhysics(entt::registry &registry, float delta, const sf::Vec
 
             // TODO: Make rope thinner the closer it is to max length
 
-            drawable.value->setPosition(
+            drawable.position = sf::Vector2f(
                 pointA.x,
                 pointA.y
             );
 
-            drawable.value->setRotation(angle * 180.f / 3.145f);
+            drawable.rotation = angle * 180.f / 3.145f;
 
-            auto *rect = dynamic_cast<sf::RectangleShape *>(drawable.value.get());
-            rect->setSize(sf::Vector2f(length, rect->getSize().y));
+            // The rope mesh is a unit long, so stretch it to the length of the joint
+            drawable.scale.x = length;
         }
     );
 
@@ -109,14 +129,17 @@ FixtureInfoPtr &Physics::makeFixture(
     entt::entity entity,
     sf::Shape *shape,
     entt::registry &reg,
-    entt::entity bodyEntity
+    entt::entity bodyEntity,
+    float simplifyTolerance
 ) {
     const BodyPtr *body = reg.try_get<BodyPtr>(bodyEntity);
     assert(body);
 
     auto *rect = dynamic_cast<sf::RectangleShape *>(shape);
     auto *circle = dynamic_cast<sf::CircleShape *>(shape);
-    auto *polygon = dynamic_cast<sf::ConvexShape *>(shape);
+    auto *convex = dynamic_cast<sf::ConvexShape *>(shape);
+    auto *mesh = dynamic_cast<MeshShape *>(shape);
+    sf::Shape *polygon = convex ? static_cast<sf::Shape *>(convex) : mesh;
 
     if (!(rect || circle || polygon)) {
         throw std::runtime_error("Unsupported shape type");
@@ -151,17 +174,25 @@ FixtureInfoPtr &Physics::makeFixture(
     }
 
     if (polygon) {
-        if (polygon->getPointCount() > 100) {
+        std::vector<sf::Vector2f> points;
+        for (size_t i = 0; i < polygon->getPointCount(); i++) {
+            points.push_back(polygon->getPoint(i));
+        }
+
+        // Detailed art doesn't need every vertex to collide with
+        points = Simplifier::simplify(points, simplifyTolerance);
+
+        if (points.size() > 100) {
             throw std::runtime_error("Polygons with more than 100 points are not supported");
         }
 
         b2Vec2 vertices[100];
-        for (size_t i = 0; i < polygon->getPointCount(); i++) {
-            vertices[i].Set(polygon->getPoint(i).x, polygon->getPoint(i).y);
+        for (size_t i = 0; i < points.size(); i++) {
+            vertices[i].Set(points[i].x, points[i].y);
         }
 
         b2PolygonShape polygonShape;
-        polygonShape.Set(vertices, polygon->getPointCount());
+        polygonShape.Set(vertices, points.size());
         fixtureShape = std::make_unique<b2PolygonShape>(polygonShape);
     }
 
@@ -197,6 +228,27 @@ float Physics::toDegrees(float deg) {
     return deg * (180.f / Physics::PI);
 }
 
+void Physics::sampleMetrics() {
+    auto &metrics = registry_.ctx_or_set<Metrics>();
+    const auto &profile = world_.GetProfile();
+
+    // Box2d times each part of the last step in milliseconds
+    metrics.sample("box2d_step_ms", profile.step);
+    metrics.sample("box2d_collide_ms", profile.collide);
+    metrics.sample("box2d_solve_ms", profile.solve);
+    metrics.sample("box2d_solve_init_ms", profile.solveInit);
+    metrics.sample("box2d_solve_velocity_ms", profile.solveVelocity);
+    metrics.sample("box2d_solve_position_ms", profile.solvePosition);
+    metrics.sample("box2d_broadphase_ms", profile.broadphase);
+    metrics.sample("box2d_solve_toi_ms", profile.solveTOI);
+
+    metrics.sample("world_bodies", world_.GetBodyCount());
+    metrics.sample("world_contacts", world_.GetContactCount());
+    metrics.sample("world_joints", world_.GetJointCount());
+    metrics.sample("world_proxies", world_.GetProxyCount());
+    metrics.increment("physics_steps");
+}
+
 void Physics::manageMovement(entt::entity entity, b2Body &body, Movement &movement) {
     if (Respawnable* respawnable = registry_.try_get<Respawnable>(entity)) {
         if (respawnable->dead) {
@@ -236,6 +288,17 @@ BodyPtr &Physics::makeBody(entt::entity entity, sf::Vector2f pos, float rot, b2B
     return body;
 }
 
+void Physics::destroyBody(entt::entity entity) {
+    auto *body = registry_.try_get<BodyPtr>(entity);
+    if (!body) {
+        return;
+    }
+
+    // The body deleter doesn't touch the world, so bodies have to be destroyed here
+    world_.DestroyBody(body->get());
+    registry_.remove<BodyPtr>(entity);
+}
+
 b2World &Physics::getWorld() {
     return world_;
 }
@@ -375,11 +438,11 @@ void ContactListener::BeginContact(b2Contact *contact) {
     fixB->numberOfContacts += 1;
 
     if (auto checkpoint = registry_.try_get<Checkpoint>(fixA->bodyEntity)) {
-        dispatcher_.enqueue(Event(fixB->bodyEntity, EnteredZone<Checkpoint> {*checkpoint}));
+        enqueueEvent(registry_, dispatcher_, Event(fixB->bodyEntity, EnteredZone<Checkpoint> {*checkpoint}));
     }
 
     if (auto deathZone = registry_.try_get<DeathZone>(fixA->bodyEntity)) {
-        dispatcher_.enqueue(Event(fixB->bodyEntity, EnteredZone<DeathZone> {*deathZone}));
+        enqueueEvent(registry_, dispatcher_, Event(fixB->bodyEntity, EnteredZone<DeathZone> {*deathZone}));
     }
 
 
@@ -442,14 +505,13 @@ float RopeHitCallback::ReportFixture(
 
     auto width = 0.1f;
 
-    auto drawable = Drawable{
-        std::make_unique<sf::RectangleShape>(sf::Vector2f(16, width)),
-        3
-    };
-    drawable.value->setOrigin(0, width / 2.f);
+    sf::RectangleShape ropeShape(sf::Vector2f(1, width));
+    ropeShape.setOrigin(0, width / 2.f);
 
-    registry_.emplace<Drawable>(rope, std::move(drawable));
+    auto drawable = registry_.ctx_or_set<MeshCache>().createDrawable(ropeShape, 3);
+    registry_.emplace<Drawable>(rope, drawable);
     registry_.emplace<HoldingRope>(entity_, HoldingRope { sf::Vector2f(point.x, point.y), rope });
+    registry_.ctx_or_set<Metrics>().increment("ropes_fired");
 
     return 0;
 }
@@ -94,12 +94,33 @@ public:
     static float toDegrees(float rad);
     b2World &getWorld();
     void handlePhysics(entt::registry &registry, float delta, const sf::Vector2f &mousePos);
+
+    /**
+     * Advance the world and handle the events that came out of it, the first half of handlePhysics
+     */
+    void step();
+
+    /**
+     * Copy bodies back to their drawables and positions and steer anything moving, the second
+     * half of handlePhysics
+     */
+    void sync(entt::registry &registry, float delta, const sf::Vector2f &mousePos);
     BodyPtr makeBody(sf::Vector2f pos, float rot = 0, b2BodyType = b2_dynamicBody);
     BodyPtr &makeBody(entt::entity entity, sf::Vector2f pos, float rot = 0, b2BodyType = b2_dynamicBody);
-    FixtureInfoPtr& makeFixture(entt::entity, sf::Shape*, entt::registry&, entt::entity body);
+    FixtureInfoPtr& makeFixture(entt::entity, sf::Shape*, entt::registry&, entt::entity body, float simplifyTolerance = 0);
+
+    /**
+     * Remove a body and its fixtures and joints from the world, the entity itself is left alone
+     */
+    void destroyBody(entt::entity entity);
 
 private:
     void manageMovement(entt::entity entity, b2Body &body, Movement &movement);
+
+    /**
+     * Add the profile and counts from the last step to the metrics in the registry context
+     */
+    void sampleMetrics();
     void rotateToPoint(b2Body &body, const sf::Vector2f &mousePos);
     bool isOnFloor(entt::entity entity);
 
@@ -0,0 +1,97 @@
+//
+// Created by derek on 29/11/20.
+//
+
+#include "render_commands.h"
+
+#include <algorithm>
+
+#include "tracer.h"
+
+const std::size_t RenderCommandBuffer::CHUNK_SIZE = 128;
+
+void RenderCommandBuffer::clear() {
+    items_.clear();
+    commands_.clear();
+    vertexCount_ = 0;
+}
+
+void RenderCommandBuffer::add(const Drawable &drawable, const RenderMesh &mesh) {
+    if (commands_.empty() || commands_.back().texture != drawable.texture) {
+        commands_.push_back(RenderCommand { drawable.texture, vertexCount_, 0 });
+    }
+
+    items_.push_back(Item { &drawable, &mesh, vertexCount_ });
+
+    // Meshes are indexed, each index becomes a vertex of a triangle
+    commands_.back().count += mesh.indices.size();
+    vertexCount_ += mesh.indices.size();
+}
+
+void RenderCommandBuffer::build(ThreadPool *pool) {
+    SLINGER_TRACE("RenderCommandBuffer::build");
+
+    if (vertices_.size() < vertexCount_) {
+        vertices_.resize(vertexCount_);
+    }
+
+    const auto chunks = (items_.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    if (pool && chunks > 1) {
+        pool->parallelFor(chunks, [this](std::size_t chunk) { buildChunk(chunk); });
+    } else {
+        for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+            buildChunk(chunk);
+        }
+    }
+}
+
+void RenderCommandBuffer::submit(sf::RenderTarget &target) const {
+    SLINGER_TRACE("RenderCommandBuffer::submit");
+
+    for (const auto &command : commands_) {
+        if (command.count > 0) {
+            target.draw(&vertices_[command.first], command.count, sf::Triangles, sf::RenderStates(command.texture));
+        }
+    }
+}
+
+const std::vector<RenderCommand> &RenderCommandBuffer::getCommands() const {
+    return commands_;
+}
+
+const sf::Vertex *RenderCommandBuffer::getVertices() const {
+    return vertices_.data();
+}
+
+std::size_t RenderCommandBuffer::getVertexCount() const {
+    return vertexCount_;
+}
+
+void RenderCommandBuffer::buildChunk(std::size_t chunk) {
+    SLINGER_TRACE("RenderCommandBuffer::buildChunk");
+
+    const auto begin = chunk * CHUNK_SIZE;
+    const auto end = std::min(begin + CHUNK_SIZE, items_.size());
+
+    for (auto i = begin; i < end; i++) {
+        const auto &drawable = *items_[i].drawable;
+        const auto &mesh = *items_[i].mesh;
+        const auto transform = drawable.getTransform();
+        const auto &rect = drawable.textureRect;
+        auto *out = &vertices_[items_[i].offset];
+
+        for (auto index : mesh.indices) {
+            const auto &vertex = mesh.vertices[index];
+
+            *out++ = sf::Vertex(
+                transform.transformPoint(vertex.position),
+                vertex.color * drawable.color,
+                sf::Vector2f(
+                    (float) rect.left + (float) rect.width * vertex.texCoords.x,
+                    (float) rect.top + (float) rect.height * vertex.texCoords.y
+                )
+            );
+        }
+    }
+}
@@ -0,0 +1,80 @@
+//
+// Created by derek on 29/11/20.
+//
+
+#ifndef SLINGER_RENDER_COMMANDS_H
+#define SLINGER_RENDER_COMMANDS_H
+
+#include <vector>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include "mesh_cache.h"
+#include "thread_pool.h"
+
+/**
+ * One draw call, a run of vertices in the buffer that share a texture
+ */
+struct RenderCommand {
+    const sf::Texture* texture = nullptr;
+    std::size_t first = 0;
+    std::size_t count = 0;
+};
+
+/**
+ * The vertices of a frame and the draw calls to submit them with. Meshes are added in the order
+ * they are drawn, which fixes where each one's vertices go, so transforming them can be split
+ * into chunks for worker threads that never write to the same place. Submitting goes through
+ * the commands in order on the thread that owns the target.
+ */
+class RenderCommandBuffer {
+    // Drawables transformed by each task, big enough that handing them out costs little
+    static const std::size_t CHUNK_SIZE;
+
+    struct Item {
+        const Drawable* drawable;
+        const RenderMesh* mesh;
+        std::size_t offset;
+    };
+
+    std::vector<Item> items_;
+    std::vector<RenderCommand> commands_;
+    std::size_t vertexCount_ = 0;
+
+    // Kept at its largest size between frames so growing it doesn't construct vertices again
+    std::vector<sf::Vertex> vertices_;
+
+public:
+    /**
+     * Start a new frame, keeping the memory of the last one
+     */
+    void clear();
+
+    /**
+     * Make room for a mesh placed by a drawable, starting a new command if the texture changes.
+     * Both have to stay alive until the buffer is submitted.
+     */
+    void add(const Drawable& drawable, const RenderMesh& mesh);
+
+    /**
+     * Write the vertices of everything added, spread across the pool when there is one
+     */
+    void build(ThreadPool* pool = nullptr);
+
+    /**
+     * Draw every command in the order they were added
+     */
+    void submit(sf::RenderTarget& target) const;
+
+    [[nodiscard]] const std::vector<RenderCommand>& getCommands() const;
+    [[nodiscard]] const sf::Vertex* getVertices() const;
+    [[nodiscard]] std::size_t getVertexCount() const;
+
+private:
+    void buildChunk(std::size_t chunk);
+};
+
+
+#endif //SLINGER_RENDER_COMMANDS_H
@@ -0,0 +1,41 @@
+//
+// Created by derek on 28/11/20.
+//
+
+#ifndef SLINGER_RENDER_SNAPSHOT_H
+#define SLINGER_RENDER_SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+
+#include <SFML/Graphics/View.hpp>
+#include <SFML/System/Time.hpp>
+
+#include "frame_stats.h"
+#include "mesh_cache.h"
+
+/**
+ * Everything needed to draw a tick, copied out of the registry when the tick ends so the frame
+ * can be drawn on another thread while the next tick runs
+ */
+struct RenderSnapshot {
+    // Counts up with each capture, meshes released before a frame are kept until it is drawn
+    std::uint64_t frame = 0;
+
+    sf::View camera;
+    sf::Vector2u windowSize;
+
+    // Drawables the camera can see in z order, ropes included
+    std::vector<Drawable> drawables;
+
+    // The level timer of the followed entity, if there is one
+    bool showTimer = false;
+    sf::Time timer;
+
+    // Only copied while the overlay is shown
+    bool showFrameStats = false;
+    FrameStats frameStats;
+};
+
+
+#endif //SLINGER_RENDER_SNAPSHOT_H
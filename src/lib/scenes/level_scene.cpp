@@ -1,28 +1,225 @@
 #include "level_scene.h"
 
-LevelScene::LevelScene(const std::string &level, sf::RenderWindow &window, entt::dispatcher& sceneDispatcher):
+#include <cstdlib>
+
+#include <spdlog/spdlog.h>
+
+#include <alloc_tracker.h>
+#include <frame_stats.h>
+#include <tracer.h>
+
+const char* LevelScene::METRICS_PATH_VARIABLE = "SLINGER_METRICS";
+const sf::Time LevelScene::TICK_TIME = sf::seconds(1.f / 60.f);
+
+LevelScene::LevelScene(const std::string &level, sf::RenderWindow &window, entt::dispatcher& sceneDispatcher,
+    ThreadPool& threadPool
+):
+    LevelScene(window, sceneDispatcher, threadPool)
+{
+    mapMaker_.make(level, &threadPool_);
+}
+
+LevelScene::LevelScene(std::uint32_t seed, sf::RenderWindow &window, entt::dispatcher &sceneDispatcher,
+    ThreadPool& threadPool
+):
+    LevelScene(window, sceneDispatcher, threadPool)
+{
+    mapMaker_.makeEndless(seed, &threadPool_);
+}
+
+LevelScene::LevelScene(sf::RenderWindow &window, entt::dispatcher &sceneDispatcher, ThreadPool& threadPool):
     window_(window),
     sceneDispatcher_(sceneDispatcher),
+    threadPool_(threadPool),
     physics_(registry_, dispatcher_),
-    illustrator_(window_, registry_, dispatcher_),
+    illustrator_(window_, registry_, dispatcher_, &threadPool_),
     inputManager_(window_, dispatcher_, sceneDispatcher_, registry_),
-    mapMaker_(registry_, physics_),
+    mapMaker_(registry_, physics_, &spikeTexture_, &atlas_),
     checkpointManager_(registry_, dispatcher_, sceneDispatcher_)
 {
-    mapMaker_.make(level);
+    window_.setFramerateLimit(60);
+
+    MapShapeBuilder::loadSpikeTexture(spikeTexture_);
+    MapShapeBuilder::addTextures(atlas_);
+    atlas_.build();
+
+    // The pool was working before this scene, only what happens from here on is reported
+    lastJobStats_ = threadPool_.getStats();
+
+    if (const char* metricsPath = std::getenv(METRICS_PATH_VARIABLE)) {
+        metricsExporter_ = std::make_unique<MetricsExporter>(registry_.ctx_or_set<Metrics>(), metricsPath);
+    }
+
+    // A context can only be active on one thread, events are still polled from this one
+    window_.setActive(false);
+    rendering_ = true;
+    renderThread_ = std::thread(&LevelScene::render, this);
+}
+
+LevelScene::~LevelScene() {
+    rendering_ = false;
+
+    // Wake the render thread if it is waiting for a snapshot
+    snapshots_.publish();
+    renderThread_.join();
+
+    window_.setActive(true);
 }
 
 void LevelScene::step() {
-    inputManager_.handleInput();
+    reportAllocations();
+
+    SLINGER_TRACE("LevelScene::step");
 
-    // Clear screen
-    window_.clear(sf::Color::White);
+    // Time each part of the frame for the frame stats overlay
+    auto delta = deltaClock_.restart();
+    auto &stats = registry_.ctx_or_set<FrameStats>();
+    stats.endFrame((float) delta.asMicroseconds() / 1000.f);
+
+    // Hardware counters, when there are any, are taken around the same sections
+    sf::Clock sectionClock;
+    auto restart = [this, &sectionClock]() {
+        sectionClock.restart();
+        perfCounters_.lap();
+    };
+    auto endSection = [this, &stats, &sectionClock](FrameStats::Section section) {
+        stats.addSection(section, (float) sectionClock.restart().asMicroseconds() / 1000.f);
+        reportPerfCounters(section, perfCounters_.lap());
+    };
+
+    restart();
+    inputManager_.handleInput(illustrator_.getCamera());
+    endSection(FrameStats::Section::INPUT);
 
     // Get the mouse pos
-    sf::Vector2f mousePos = window_.mapPixelToCoords(sf::Mouse::getPosition(window_));
+    sf::Vector2f mousePos = window_.mapPixelToCoords(sf::Mouse::getPosition(window_), illustrator_.getCamera());
 
-    auto delta = deltaClock_.restart();
+    restart();
     checkpointManager_.update(delta);
-    physics_.handlePhysics(registry_, delta.asSeconds(), mousePos);
-    illustrator_.draw(registry_);
-}
\ No newline at end of file
+    endSection(FrameStats::Section::CHECKPOINTS);
+
+    physics_.step();
+    endSection(FrameStats::Section::PHYSICS);
+
+    physics_.sync(registry_, delta.asSeconds(), mousePos);
+    endSection(FrameStats::Section::SYNC);
+
+    mapMaker_.update();
+
+    if (metricsExporter_) {
+        // Writing the metrics out is bookkeeping, not part of the frame
+        AllocPause pause;
+        metricsExporter_->update(delta.asSeconds());
+    }
+
+    reportJobs();
+
+    // Drawing happens on the render thread, this is how long it took to draw the latest frame
+    stats.addSection(FrameStats::Section::DRAW, drawMilliseconds_.load(std::memory_order_relaxed));
+
+    PerfCounters::Counts drawCounts;
+    for (std::size_t i = 0; i < drawCounts.size(); i++) {
+        drawCounts[i] = drawCounts_[i].load(std::memory_order_relaxed);
+    }
+    reportPerfCounters(FrameStats::Section::DRAW, drawCounts);
+
+    const auto &world = physics_.getWorld();
+    stats.setCounters(FrameStats::Counters {
+        (std::size_t) world.GetBodyCount(),
+        (std::size_t) world.GetContactCount(),
+        (std::size_t) world.GetProxyCount(),
+        registry_.view<Drawable>().size()
+    });
+
+    illustrator_.capture(snapshots_.back());
+    snapshots_.publish();
+
+    SLINGER_TRACE("LevelScene::wait");
+    sf::sleep(TICK_TIME - tickClock_.getElapsedTime());
+    tickClock_.restart();
+}
+
+void LevelScene::render() {
+    Tracer::setThreadName("render");
+
+    if (!window_.setActive(true)) {
+        SPDLOG_LOGGER_ERROR(log_, "Could not use the window from the render thread");
+        return;
+    }
+
+    PerfCounters perfCounters;
+    sf::Clock drawClock;
+
+    while (true) {
+        snapshots_.wait();
+        if (!rendering_) {
+            break;
+        }
+
+        snapshots_.update();
+
+        drawClock.restart();
+        perfCounters.lap();
+
+        illustrator_.draw(snapshots_.front());
+
+        drawMilliseconds_.store((float) drawClock.getElapsedTime().asMicroseconds() / 1000.f, std::memory_order_relaxed);
+        auto counts = perfCounters.lap();
+        for (std::size_t i = 0; i < counts.size(); i++) {
+            drawCounts_[i].store(counts[i], std::memory_order_relaxed);
+        }
+
+        SLINGER_TRACE("RenderWindow::display");
+        window_.display();
+    }
+
+    window_.setActive(false);
+}
+
+void LevelScene::reportAllocations() {
+    if (!AllocTracker::isEnabled()) {
+        return;
+    }
+
+    auto report = AllocTracker::endFrame();
+
+    // Naming the metrics allocates, which shouldn't count against the next frame
+    AllocPause pause;
+    auto &metrics = registry_.ctx_or_set<Metrics>();
+
+    for (const auto &system : report.systems) {
+        auto name = Metrics::toMetricName(system.name);
+        metrics.sample("alloc_count_" + name, (double) system.allocations);
+        metrics.sample("alloc_bytes_" + name, (double) system.bytes);
+    }
+
+    metrics.sample("alloc_count", (double) report.allocations);
+    metrics.sample("alloc_bytes", (double) report.bytes);
+}
+
+void LevelScene::reportPerfCounters(FrameStats::Section section, const PerfCounters::Counts &counts) {
+    if (!perfCounters_.isAvailable()) {
+        return;
+    }
+
+    AllocPause pause;
+    auto &metrics = registry_.ctx_or_set<Metrics>();
+    auto prefix = std::string("perf_") + FrameStats::SECTION_NAMES[(std::size_t) section] + "_";
+
+    for (std::size_t i = 0; i < counts.size(); i++) {
+        if (perfCounters_.isCounting((PerfCounters::Event) i)) {
+            metrics.sample(prefix + PerfCounters::EVENT_NAMES[i], (double) counts[i]);
+        }
+    }
+}
+
+void LevelScene::reportJobs() {
+    auto stats = threadPool_.getStats();
+    auto &metrics = registry_.ctx_or_set<Metrics>();
+
+    metrics.sample("jobs_queued", (double) stats.queued);
+    metrics.increment("jobs_executed", (double) (stats.executed - lastJobStats_.executed));
+    metrics.increment("jobs_stolen", (double) (stats.stolen - lastJobStats_.stolen));
+
+    lastJobStats_ = stats;
+}
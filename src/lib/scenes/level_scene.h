@@ -1,31 +1,111 @@
 #ifndef SLINGER_LEVEL_SCENE_H
 #define SLINGER_LEVEL_SCENE_H
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <physics.h>
 #include <illustrator.h>
 #include <input_manager.h>
+#include <logging.h>
 #include <map_maker/map_maker.h>
 #include <checkpoint_manager.h>
+#include <texture_atlas.h>
+#include <thread_pool.h>
+#include <metrics.h>
+#include <frame_stats.h>
+#include <perf_counters.h>
+#include <render_snapshot.h>
+#include <triple_buffer.h>
 #include "scene.h"
 
+/**
+ * Plays a level with the game and drawing on separate threads. Each tick runs input, physics
+ * and checkpoints on the thread that made the window, then publishes a snapshot of what to
+ * draw. A render thread draws the latest snapshot and waits on display, so a slow frame or
+ * vsync never holds up a tick and a slow tick never stops the last one being shown.
+ */
 class LevelScene : public Scene {
+    // Set this to a file to have engine metrics written to it while a level is played
+    static const char* METRICS_PATH_VARIABLE;
+
+    // Ticks are paced on their own now display doesn't do it for them
+    static const sf::Time TICK_TIME;
+
     sf::RenderWindow& window_;
     entt::dispatcher& sceneDispatcher_;
+    ThreadPool& threadPool_;
 
     entt::registry registry_;
     entt::dispatcher dispatcher_;
     sf::Clock deltaClock_;
+    sf::Clock tickClock_;
 
     Physics physics_;
     Illustrator illustrator_;
     InputManager inputManager_;
+    sf::Texture spikeTexture_;
+    TextureAtlas atlas_;
     MapMaker mapMaker_;
     CheckpointManager checkpointManager_;
+    std::unique_ptr<MetricsExporter> metricsExporter_;
+    PerfCounters perfCounters_;
+    ThreadPool::Stats lastJobStats_;
+
+    TripleBuffer<RenderSnapshot> snapshots_;
+    std::atomic<bool> rendering_ {false};
+
+    // Written by the render thread after each frame it draws, for the frame stats and metrics
+    std::atomic<float> drawMilliseconds_ {0.f};
+    std::array<std::atomic<std::uint64_t>, (std::size_t) PerfCounters::Event::COUNT> drawCounts_ {};
+
+    std::thread renderThread_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::RENDER);
 
 public:
-    explicit LevelScene(const std::string& level, sf::RenderWindow& window, entt::dispatcher& sceneDispatcher);
+    /**
+     * @param threadPool workers for loading and drawing, owned by whoever switches scenes
+     */
+    LevelScene(const std::string& level, sf::RenderWindow& window, entt::dispatcher& sceneDispatcher,
+        ThreadPool& threadPool);
+
+    /**
+     * An endless climb generated from the seed
+     */
+    LevelScene(std::uint32_t seed, sf::RenderWindow& window, entt::dispatcher& sceneDispatcher, ThreadPool& threadPool);
+
+    /**
+     * Stops the render thread and hands the window back to the calling thread
+     */
+    ~LevelScene() override;
+
     void step() override;
+
+private:
+    LevelScene(sf::RenderWindow& window, entt::dispatcher& sceneDispatcher, ThreadPool& threadPool);
+
+    /**
+     * Draw snapshots as they are published until the scene ends, run on the render thread
+     */
+    void render();
+
+    /**
+     * Add what each system allocated last frame to the metrics, when allocations are tracked
+     */
+    void reportAllocations();
+
+    /**
+     * Add the hardware counters from a section of the frame to the metrics, when there are any
+     */
+    void reportPerfCounters(FrameStats::Section section, const PerfCounters::Counts& counts);
+
+    /**
+     * Add how deep the job queues are and how much was run and stolen since the last tick
+     */
+    void reportJobs();
 };
 
 
@@ -34,6 +34,7 @@ MainMenuScene::MainMenuScene(
     for (const auto& level : getLevels(levelLocation, times)) {
         menu_.addItem(level.getDisplayName(), StartLevel(level.getPath().generic_string()));
     }
+    menu_.addItem("Endless climb", StartEndless());
     menu_.addSpacer();
     menu_.addItem("How to Play", OpenTutorial());
     menu_.addItem("Exit", ExitGame());
@@ -51,7 +52,7 @@ void MainMenuScene::step() {
     while (window_.pollEvent(event)) {
         if (event.type == sf::Event::Closed)
         {
-           SPDLOG_INFO("Closing game from main menu window exit button");
+           SPDLOG_LOGGER_INFO(log_, "Closing game from main menu window exit button");
            sceneDispatcher_.enqueue(ExitGame {});
         }
 
@@ -67,7 +68,7 @@ void MainMenuScene::step() {
         }
 
         if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Escape) {
-            SPDLOG_INFO("Closing game from main menu window with escape key");
+            SPDLOG_LOGGER_INFO(log_, "Closing game from main menu window with escape key");
             sceneDispatcher_.enqueue(ExitGame());
         }
     }
@@ -268,7 +269,7 @@ void MenuItem::handleMousePress(float x, float y, entt::dispatcher &dispatcher)
         return;
     }
 
-    SPDLOG_INFO("'{}' button clicked", std::string(label_.getString()));
+    SPDLOG_LOGGER_INFO(log_, "'{}' button clicked", std::string(label_.getString()));
 
     // TODO: Find a way to template this out
 
@@ -283,6 +284,10 @@ void MenuItem::handleMousePress(float x, float y, entt::dispatcher &dispatcher)
     if (std::holds_alternative<OpenTutorial>(menuAction_)) {
         dispatcher.enqueue(std::get<OpenTutorial>(menuAction_));
     }
+
+    if (std::holds_alternative<StartEndless>(menuAction_)) {
+        dispatcher.enqueue(std::get<StartEndless>(menuAction_));
+    }
 }
 
 LevelInfo::LevelInfo(std::filesystem::path path, std::optional<sf::Time> completionTime):
@@ -11,9 +11,10 @@
 #include <nlohmann/json.hpp>
 #include <optional>
 
+#include "logging.h"
 #include "scene.h"
 
-using MenuAction = std::variant<ExitGame, StartLevel, std::monostate, OpenTutorial>;
+using MenuAction = std::variant<ExitGame, StartLevel, std::monostate, OpenTutorial, StartEndless>;
 
 class MenuItem {
     const static float PADDING;
@@ -23,6 +24,7 @@ class MenuItem {
     sf::RectangleShape border_;
     const bool title_;
     const MenuAction menuAction_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::SCENES);
 
 public:
     explicit MenuItem(sf::Text label_, MenuAction action, bool title = false);
@@ -79,6 +81,7 @@ class MainMenuScene : public Scene {
     const std::string& levelLocation_;
     sf::RenderWindow& window_;
     entt::dispatcher& sceneDispatcher_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::SCENES);
 
     sf::Font font_;
     sf::Text authorText_;
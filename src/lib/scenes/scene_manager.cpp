@@ -1,5 +1,6 @@
 #include <spdlog/spdlog.h>
 #include <fstream>
+#include <random>
 
 #include "scene_manager.h"
 #include "main_menu_scene.h"
@@ -14,6 +15,7 @@ SceneManager::SceneManager(sf::RenderWindow &window, std::optional<std::string>
 {
     sceneDispatcher_.sink<ExitGame>().connect<&SceneManager::exitGame>(this);
     sceneDispatcher_.sink<StartLevel>().connect<&SceneManager::startLevel>(this);
+    sceneDispatcher_.sink<StartEndless>().connect<&SceneManager::startEndless>(this);
     sceneDispatcher_.sink<FinishLevel>().connect<&SceneManager::finishLevel>(this);
     sceneDispatcher_.sink<ExitLevel>().connect<&SceneManager::exitLevel>(this);
     sceneDispatcher_.sink<OpenTutorial>().connect<&SceneManager::openTutorial>(this);
@@ -33,17 +35,22 @@ void SceneManager::run() {
 }
 
 void SceneManager::exitGame(ExitGame event) {
-    SPDLOG_INFO("Attempting to exit game");
+    SPDLOG_LOGGER_INFO(log_, "Attempting to exit game");
     shouldExit_ = true;
 }
 
 void SceneManager::startLevel(const StartLevel &event) {
     lastLevelPath_ = event.levelPath;
-    scene_ = std::make_unique<LevelScene>(event.levelPath, window_, sceneDispatcher_);
+    scene_ = std::make_unique<LevelScene>(event.levelPath, window_, sceneDispatcher_, threadPool_);
+}
+
+void SceneManager::startEndless(const StartEndless &event) {
+    std::random_device random;
+    scene_ = std::make_unique<LevelScene>(random(), window_, sceneDispatcher_, threadPool_);
 }
 
 void SceneManager::finishLevel(const FinishLevel &event) {
-    SPDLOG_INFO("Finished level {} with time {}", lastLevelPath_, formatTime(event.completeTime));
+    SPDLOG_LOGGER_INFO(log_, "Finished level {} with time {}", lastLevelPath_, formatTime(event.completeTime));
     writeLevelTime(lastLevelPath_, event.completeTime);
     openMainMenu();
 }
@@ -52,7 +59,7 @@ void SceneManager::writeLevelTime(const std::string &levelPath, const sf::Time &
     auto times = getLevelTimes();
 
     if (times.contains(levelPath) && times[levelPath] < levelTime.asMilliseconds()) {
-        SPDLOG_INFO("Not writing time of {} for {} because the existing time of {} is less",
+        SPDLOG_LOGGER_INFO(log_, "Not writing time of {} for {} because the existing time of {} is less",
             levelTime.asMilliseconds(), levelPath, times[levelPath].get<int>());
         return;
     }
@@ -62,7 +69,7 @@ void SceneManager::writeLevelTime(const std::string &levelPath, const sf::Time &
     std::ofstream outputFile(SceneManager::LEVEL_TIMES_PATH);
     outputFile << std::setw(4) << times << std::endl;
 
-    SPDLOG_INFO("Written new time of {} for level {}", levelTime.asMilliseconds(), levelPath);
+    SPDLOG_LOGGER_INFO(log_, "Written new time of {} for level {}", levelTime.asMilliseconds(), levelPath);
 }
 
 SceneManager::json SceneManager::getLevelTimes() {
@@ -8,7 +8,9 @@
 #include <entt/signal/dispatcher.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <events.h>
+#include <logging.h>
 #include <nlohmann/json.hpp>
+#include <thread_pool.h>
 #include "scene.h"
 
 class SceneManager {
@@ -17,20 +19,24 @@ class SceneManager {
     const static std::string LEVEL_PATH;
     const static std::string LEVEL_TIMES_PATH;
 
+    // Shared by every scene, and outlives them so their tasks can finish as they are replaced
+    ThreadPool threadPool_;
     std::unique_ptr<Scene> scene_;
     entt::dispatcher sceneDispatcher_;
     sf::RenderWindow& window_;
     std::string lastLevelPath_;
     bool shouldExit_ = false;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::SCENES);
 
     static json getLevelTimes();
-    static void writeLevelTime(const std::string& levelPath, const sf::Time& levelTime);
+    void writeLevelTime(const std::string& levelPath, const sf::Time& levelTime);
 
     void openMainMenu();
 
     // Event handlers
     void exitGame(ExitGame event);
     void startLevel(const StartLevel& event);
+    void startEndless(const StartEndless& event);
     void finishLevel(const FinishLevel& event);
     void exitLevel(const ExitLevel& event);
     void openTutorial(const OpenTutorial& event);
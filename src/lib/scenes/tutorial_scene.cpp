@@ -26,7 +26,7 @@ void TutorialScene::step() {
     while (window_.pollEvent(event)) {
         if (event.type == sf::Event::Closed)
         {
-            SPDLOG_INFO("Closing game from tutorial");
+            SPDLOG_LOGGER_INFO(log_, "Closing game from tutorial");
             sceneDispatcher_.enqueue(ExitGame {});
         }
 
@@ -37,7 +37,7 @@ void TutorialScene::step() {
         }
 
         if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Escape) {
-            SPDLOG_INFO("Returning to menu from tutorial");
+            SPDLOG_LOGGER_INFO(log_, "Returning to menu from tutorial");
             sceneDispatcher_.enqueue(ExitLevel());
         }
     }
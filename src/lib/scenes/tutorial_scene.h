@@ -6,6 +6,7 @@
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <entt/signal/dispatcher.hpp>
+#include "logging.h"
 #include "scene.h"
 
 class TutorialScene : public Scene {
@@ -13,6 +14,7 @@ class TutorialScene : public Scene {
 
     sf::RenderWindow& window_;
     entt::dispatcher& sceneDispatcher_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::SCENES);
 
     sf::Texture image_;
     sf::Sprite tutorial_;
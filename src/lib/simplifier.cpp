@@ -0,0 +1,108 @@
+//
+// Created by derek on 12/11/20.
+//
+
+#include "simplifier.h"
+
+#include <cmath>
+#include <stack>
+#include <utility>
+
+std::vector<sf::Vector2f> Simplifier::simplify(const std::vector<sf::Vector2f> &points, float tolerance) {
+    if (tolerance <= 0.f || points.size() < 4) {
+        return points;
+    }
+
+    const bool closed = points.front() == points.back();
+
+    // Closed paths are split in two at the point furthest from the start, otherwise the
+    // start and end would be the same point and there'd be no segment to measure against
+    std::vector<sf::Vector2f> path(points.begin(), closed ? points.end() - 1 : points.end());
+    std::size_t split = path.size() - 1;
+
+    if (closed) {
+        float furthest = -1;
+
+        for (std::size_t i = 1; i < path.size(); i++) {
+            auto d = path[i] - path[0];
+            if (d.x * d.x + d.y * d.y > furthest) {
+                furthest = d.x * d.x + d.y * d.y;
+                split = i;
+            }
+        }
+
+        path.push_back(path.front());
+    }
+
+    std::vector<bool> keep(path.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+    keep[split] = true;
+
+    keepFurthest(path, 0, split, tolerance, keep);
+    keepFurthest(path, split, path.size() - 1, tolerance, keep);
+
+    std::vector<sf::Vector2f> simplified;
+    for (std::size_t i = 0; i < path.size(); i++) {
+        if (keep[i]) {
+            simplified.push_back(path[i]);
+        }
+    }
+
+    // A closed path needs three corners and the closing point to still be a polygon
+    if (simplified.size() < (closed ? 4u : 2u)) {
+        return points;
+    }
+
+    return simplified;
+}
+
+float Simplifier::distanceToSegment(const sf::Vector2f &point, const sf::Vector2f &start, const sf::Vector2f &end) {
+    auto segment = end - start;
+    auto toPoint = point - start;
+    float lengthSquared = segment.x * segment.x + segment.y * segment.y;
+
+    float t = 0;
+    if (lengthSquared > 0) {
+        t = std::fmax(0.f, std::fmin(1.f, (toPoint.x * segment.x + toPoint.y * segment.y) / lengthSquared));
+    }
+
+    auto closest = start + segment * t;
+    auto d = point - closest;
+
+    return std::sqrt(d.x * d.x + d.y * d.y);
+}
+
+void Simplifier::keepFurthest(
+    const std::vector<sf::Vector2f> &points,
+    std::size_t start,
+    std::size_t end,
+    float tolerance,
+    std::vector<bool> &keep
+) {
+    // Iterate rather than recurse, authored paths can have thousands of points
+    std::stack<std::pair<std::size_t, std::size_t>> ranges;
+    ranges.emplace(start, end);
+
+    while (!ranges.empty()) {
+        auto [first, last] = ranges.top();
+        ranges.pop();
+
+        float furthest = 0;
+        std::size_t index = first;
+
+        for (std::size_t i = first + 1; i < last; i++) {
+            float distance = distanceToSegment(points[i], points[first], points[last]);
+            if (distance > furthest) {
+                furthest = distance;
+                index = i;
+            }
+        }
+
+        if (furthest > tolerance) {
+            keep[index] = true;
+            ranges.emplace(first, index);
+            ranges.emplace(index, last);
+        }
+    }
+}
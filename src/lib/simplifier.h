@@ -0,0 +1,32 @@
+//
+// Created by derek on 12/11/20.
+//
+
+#ifndef SLINGER_SIMPLIFIER_H
+#define SLINGER_SIMPLIFIER_H
+
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+/**
+ * Reduces the number of points in a path with the Ramer-Douglas-Peucker algorithm
+ */
+class Simplifier {
+public:
+    /**
+     * Remove every point that is closer than the tolerance to the simplified path. Closed
+     * paths, where the first and last points match, stay closed.
+     * @param points the path to simplify
+     * @param tolerance the furthest a removed point may be from the result
+     * @return the simplified path, or the original if simplifying would leave less than a triangle
+     */
+    static std::vector<sf::Vector2f> simplify(const std::vector<sf::Vector2f>& points, float tolerance);
+
+private:
+    static float distanceToSegment(const sf::Vector2f& point, const sf::Vector2f& start, const sf::Vector2f& end);
+    static void keepFurthest(const std::vector<sf::Vector2f>& points, std::size_t start, std::size_t end, float tolerance, std::vector<bool>& keep);
+};
+
+
+#endif //SLINGER_SIMPLIFIER_H
@@ -0,0 +1,172 @@
+//
+// Created by derek on 02/11/20.
+//
+
+#include "texture_atlas.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+
+// Large enough for the running sheet to share a page with the smaller images
+const unsigned int TextureAtlas::PAGE_SIZE = 8192;
+const unsigned int TextureAtlas::PADDING = 1;
+
+sf::IntRect AtlasRegion::map(const sf::IntRect &local) const {
+    return sf::IntRect(rect.left + local.left, rect.top + local.top, local.width, local.height);
+}
+
+void TextureAtlas::add(const std::string &name, const std::string &path) {
+    PendingImage pending { name, sf::Image() };
+
+    if (!pending.image.loadFromFile(path)) {
+        throw std::runtime_error("Could not load image for atlas: " + path);
+    }
+
+    pending_.push_back(std::move(pending));
+}
+
+void TextureAtlas::build() {
+    struct Placement {
+        std::size_t image;
+        std::size_t page;
+        unsigned int x;
+        unsigned int y;
+    };
+
+    const unsigned int maxSize = std::min(PAGE_SIZE, sf::Texture::getMaximumSize());
+
+    // Tall images first keeps the shelves tight
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < pending_.size(); i++) {
+        order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [this](std::size_t lhs, std::size_t rhs) {
+        return pending_[lhs].image.getSize().y > pending_[rhs].image.getSize().y;
+    });
+
+    std::vector<Placement> placements;
+    std::vector<sf::Vector2u> pageSizes;
+    unsigned int shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+    for (auto index : order) {
+        auto &pending = pending_[index];
+        auto size = pending.image.getSize();
+        auto width = size.x + PADDING * 2;
+        auto height = size.y + PADDING * 2;
+
+        if (width > maxSize || height > maxSize) {
+            regions_[pending.name] = AtlasRegion {
+                upload(pending.image),
+                sf::IntRect(0, 0, (int) size.x, (int) size.y)
+            };
+            continue;
+        }
+
+        // Start a new shelf, or a new page if the shelf would not fit
+        if (pageSizes.empty() || shelfX + width > maxSize) {
+            shelfX = 0;
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+        }
+
+        if (pageSizes.empty() || shelfY + height > maxSize) {
+            pageSizes.emplace_back(0, 0);
+            shelfX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+
+        placements.push_back(Placement { index, pageSizes.size() - 1, shelfX, shelfY });
+
+        shelfX += width;
+        shelfHeight = std::max(shelfHeight, height);
+        pageSizes.back().x = std::max(pageSizes.back().x, shelfX);
+        pageSizes.back().y = std::max(pageSizes.back().y, shelfY + shelfHeight);
+    }
+
+    std::vector<sf::Image> pages(pageSizes.size());
+    for (std::size_t i = 0; i < pages.size(); i++) {
+        pages[i].create(pageSizes[i].x, pageSizes[i].y, sf::Color::Transparent);
+    }
+
+    for (const auto &placement : placements) {
+        blit(pages[placement.page], pending_[placement.image].image, placement.x, placement.y);
+    }
+
+    std::vector<const sf::Texture*> textures;
+    for (const auto &page : pages) {
+        textures.push_back(upload(page));
+    }
+
+    for (const auto &placement : placements) {
+        auto &pending = pending_[placement.image];
+        regions_[pending.name] = AtlasRegion {
+            textures[placement.page],
+            sf::IntRect(
+                (int) (placement.x + PADDING),
+                (int) (placement.y + PADDING),
+                (int) pending.image.getSize().x,
+                (int) pending.image.getSize().y
+            )
+        };
+    }
+
+    SPDLOG_LOGGER_INFO(log_, "Packed {} images into {} atlas pages", pending_.size(), pages_.size());
+    pending_.clear();
+}
+
+const AtlasRegion &TextureAtlas::get(const std::string &name) const {
+    auto region = regions_.find(name);
+
+    if (region == regions_.end()) {
+        throw std::runtime_error("Could not find atlas region: " + name);
+    }
+
+    return region->second;
+}
+
+bool TextureAtlas::contains(const std::string &name) const {
+    return regions_.contains(name);
+}
+
+std::size_t TextureAtlas::pageCount() const {
+    return pages_.size();
+}
+
+const sf::Texture* TextureAtlas::upload(const sf::Image &page) {
+    auto texture = std::make_unique<sf::Texture>();
+
+    if (!texture->loadFromImage(page)) {
+        throw std::runtime_error("Could not upload atlas page");
+    }
+
+    texture->setSmooth(true);
+
+    pages_.push_back(std::move(texture));
+    return pages_.back().get();
+}
+
+void TextureAtlas::blit(sf::Image &page, const sf::Image &image, unsigned int x, unsigned int y) {
+    const int width = (int) image.getSize().x;
+    const int height = (int) image.getSize().y;
+
+    page.copy(image, x + PADDING, y + PADDING);
+
+    // Smear the edge pixels into the padding so filtering doesn't bleed in the neighbours
+    for (unsigned int p = 0; p < PADDING; p++) {
+        page.copy(image, x + PADDING, y + p, sf::IntRect(0, 0, width, 1));
+        page.copy(image, x + PADDING, y + PADDING + height + p, sf::IntRect(0, height - 1, width, 1));
+    }
+
+    for (unsigned int p = 0; p < PADDING; p++) {
+        page.copy(page, x + p, y, sf::IntRect((int) (x + PADDING), (int) y, 1, height + (int) PADDING * 2));
+        page.copy(
+            page,
+            x + PADDING + width + p,
+            y,
+            sf::IntRect((int) (x + PADDING) + width - 1, (int) y, 1, height + (int) PADDING * 2)
+        );
+    }
+}
@@ -0,0 +1,76 @@
+//
+// Created by derek on 02/11/20.
+//
+
+#ifndef SLINGER_TEXTURE_ATLAS_H
+#define SLINGER_TEXTURE_ATLAS_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include "logging.h"
+
+/**
+ * The location of a single image inside of an atlas page
+ */
+struct AtlasRegion {
+    const sf::Texture* texture = nullptr;
+    sf::IntRect rect;
+
+    /**
+     * Convert a rect local to the original image into a rect on the atlas page
+     */
+    [[nodiscard]] sf::IntRect map(const sf::IntRect& local) const;
+};
+
+/**
+ * Packs images into a small number of shared textures so that shapes using different
+ * images can be drawn without switching textures.
+ *
+ * Only images drawn within their own bounds can be packed. Tiling needs the GPU to repeat a
+ * whole texture, so repeated images such as the spikes have to be loaded as textures of
+ * their own instead.
+ */
+class TextureAtlas {
+    struct PendingImage {
+        std::string name;
+        sf::Image image;
+    };
+
+    std::vector<PendingImage> pending_;
+    std::vector<std::unique_ptr<sf::Texture>> pages_;
+    std::unordered_map<std::string, AtlasRegion> regions_;
+    std::shared_ptr<spdlog::logger> log_ = Logging::get(Logging::RENDER);
+
+public:
+    static const unsigned int PAGE_SIZE;
+    static const unsigned int PADDING;
+
+    /**
+     * Queue an image to be packed
+     */
+    void add(const std::string& name, const std::string& path);
+
+    /**
+     * Pack every queued image into atlas pages and upload them. Images too big to share a
+     * page are uploaded on a page of their own.
+     */
+    void build();
+
+    [[nodiscard]] const AtlasRegion& get(const std::string& name) const;
+    [[nodiscard]] bool contains(const std::string& name) const;
+    [[nodiscard]] std::size_t pageCount() const;
+
+private:
+    const sf::Texture* upload(const sf::Image& page);
+    static void blit(sf::Image& page, const sf::Image& image, unsigned int x, unsigned int y);
+};
+
+
+#endif //SLINGER_TEXTURE_ATLAS_H
@@ -0,0 +1,256 @@
+//
+// Created by derek on 16/11/20.
+//
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "tracer.h"
+
+namespace {
+    // Which pool the current thread works for, and which of its workers it is
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local std::size_t currentWorker = 0;
+}
+
+bool JobCounter::isDone() const {
+    return remaining_ == 0;
+}
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    // hardware_concurrency is allowed to return 0 if it can't tell
+    threads = std::max<std::size_t>(threads, 1);
+
+    for (std::size_t i = 0; i < threads; i++) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    for (std::size_t i = 0; i < threads; i++) {
+        workers_.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(sleepMutex_);
+        stopping_ = true;
+    }
+
+    wake_.notify_all();
+
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(JobCounter &counter, std::function<void()> job) {
+    counter.remaining_++;
+
+    push([&counter, job = std::move(job)]() {
+        try {
+            job();
+        } catch (...) {
+            std::lock_guard lock(counter.mutex_);
+            if (!counter.error_) {
+                counter.error_ = std::current_exception();
+            }
+        }
+
+        // Notified under the lock so the waiter can't return and destroy the counter mid-notify
+        std::lock_guard lock(counter.mutex_);
+        if (--counter.remaining_ == 0) {
+            counter.finished_.notify_all();
+        }
+    });
+}
+
+void ThreadPool::wait(JobCounter &counter) {
+    if (isWorker()) {
+        // Blocking here could leave every worker waiting on jobs none of them are free to run
+        std::function<void()> task;
+
+        while (!counter.isDone()) {
+            if (take(currentWorker, task)) {
+                executed_++;
+                task();
+                task = nullptr;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::unique_lock lock(counter.mutex_);
+    counter.finished_.wait(lock, [&counter]() { return counter.remaining_ == 0; });
+
+    if (counter.error_) {
+        std::rethrow_exception(std::exchange(counter.error_, nullptr));
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)> &body) {
+    if (count == 0) {
+        return;
+    }
+
+    struct State {
+        std::atomic<std::size_t> next = 0;
+        std::size_t count;
+        const std::function<void(std::size_t)>* body;
+
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::size_t active = 0;
+        std::exception_ptr error;
+    };
+
+    auto state = std::make_shared<State>();
+    state->count = count;
+    state->body = &body;
+
+    // Each runner takes the next index until there are none left, so uneven work balances out
+    auto run = [](State& state) {
+        try {
+            for (auto i = state.next++; i < state.count; i = state.next++) {
+                (*state.body)(i);
+            }
+        } catch (...) {
+            std::lock_guard lock(state.mutex);
+            if (!state.error) {
+                state.error = std::current_exception();
+            }
+
+            // Stop handing out work once something has failed
+            state.next = state.count;
+        }
+    };
+
+    // Helpers that only start once every index is taken return straight away, so the caller
+    // only has to wait for the ones that joined in. Waiting on every helper instead would
+    // deadlock nested calls when all of the workers are busy waiting themselves.
+    const auto helpers = std::min(workers_.size(), count - 1);
+    for (std::size_t i = 0; i < helpers; i++) {
+        submit([state, run]() {
+            {
+                std::lock_guard lock(state->mutex);
+                if (state->next >= state->count) {
+                    return;
+                }
+
+                state->active++;
+            }
+
+            run(*state);
+
+            std::lock_guard lock(state->mutex);
+            state->active--;
+            state->finished.notify_all();
+        });
+    }
+
+    run(*state);
+
+    std::unique_lock lock(state->mutex);
+    state->finished.wait(lock, [&state]() { return state->active == 0; });
+
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+std::size_t ThreadPool::size() const {
+    return workers_.size();
+}
+
+ThreadPool::Stats ThreadPool::getStats() const {
+    return Stats { queued_, executed_, stolen_ };
+}
+
+void ThreadPool::push(std::function<void()> task) {
+    // Counted first so it can never be taken before it is counted
+    queued_++;
+
+    auto &queue = isWorker() ? *queues_[currentWorker] : shared_;
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    // Taking the lock means a worker that just found nothing is either still checking, and
+    // will see the count, or already waiting to be woken
+    {
+        std::lock_guard lock(sleepMutex_);
+    }
+    wake_.notify_one();
+}
+
+bool ThreadPool::take(std::size_t worker, std::function<void()> &task) {
+    {
+        auto &own = *queues_[worker];
+        std::lock_guard lock(own.mutex);
+
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued_--;
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard lock(shared_.mutex);
+
+        if (!shared_.tasks.empty()) {
+            task = std::move(shared_.tasks.front());
+            shared_.tasks.pop_front();
+            queued_--;
+            return true;
+        }
+    }
+
+    // Steal the oldest task, which is likely the biggest left, starting from the next worker
+    for (std::size_t i = 1; i < queues_.size(); i++) {
+        auto &victim = *queues_[(worker + i) % queues_.size()];
+        std::lock_guard lock(victim.mutex);
+
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued_--;
+            stolen_++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::isWorker() const {
+    return currentPool == this;
+}
+
+void ThreadPool::work(std::size_t worker) {
+    Tracer::setThreadName("worker");
+    currentPool = this;
+    currentWorker = worker;
+
+    std::function<void()> task;
+
+    while (true) {
+        if (take(worker, task)) {
+            executed_++;
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex_);
+        wake_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+
+        if (stopping_ && queued_ == 0) {
+            return;
+        }
+    }
+}
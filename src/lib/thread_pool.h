@@ -0,0 +1,150 @@
+//
+// Created by derek on 16/11/20.
+//
+
+#ifndef SLINGER_THREAD_POOL_H
+#define SLINGER_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Counts jobs that haven't finished yet, so whatever depends on them can wait for all of them.
+ * The first exception any of them throws is kept for the wait to rethrow.
+ */
+class JobCounter {
+    friend class ThreadPool;
+
+    std::atomic<std::size_t> remaining_ = 0;
+    std::mutex mutex_;
+    std::condition_variable finished_;
+    std::exception_ptr error_;
+
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    [[nodiscard]] bool isDone() const;
+};
+
+/**
+ * A fixed set of worker threads that each keep their own queue. A worker runs the newest task it
+ * queued itself first, so nested work stays on the same core while it is warm, then takes from
+ * the tasks queued by other threads in order, then steals the oldest task another worker has
+ * queued once it has nothing else to do.
+ */
+class ThreadPool {
+public:
+    struct Stats {
+        // Tasks waiting for a thread to start them
+        std::size_t queued = 0;
+
+        // Tasks a thread has started
+        std::uint64_t executed = 0;
+
+        // Tasks one worker took from another's queue
+        std::uint64_t stolen = 0;
+    };
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // One for each worker, and one shared for tasks queued from any other thread
+    std::vector<std::unique_ptr<Queue>> queues_;
+    Queue shared_;
+    std::vector<std::thread> workers_;
+
+    // Workers with nothing to do sleep until something is queued
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+
+    std::atomic<std::size_t> queued_ = 0;
+    std::atomic<std::uint64_t> executed_ = 0;
+    std::atomic<std::uint64_t> stolen_ = 0;
+
+public:
+    /**
+     * @param threads the number of workers, defaults to one per hardware thread
+     */
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+
+    /**
+     * Runs everything still queued before the workers stop
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Queue a task, any exception it throws is rethrown from the future
+     */
+    template <class F>
+    std::future<std::invoke_result_t<F>> submit(F&& task);
+
+    /**
+     * Queue a job that the counter waits for. The counter has to outlive the job.
+     */
+    void run(JobCounter& counter, std::function<void()> job);
+
+    /**
+     * Return once every job run against the counter has finished, rethrowing the first exception
+     * one of them threw. Workers keep running other tasks while they wait rather than blocking,
+     * so jobs can wait on jobs of their own.
+     */
+    void wait(JobCounter& counter);
+
+    /**
+     * Run the body for every index from 0 to count across the workers and the calling thread,
+     * returning once they have all finished. The first exception thrown is rethrown.
+     */
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body);
+
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * How much is queued and how much work has moved between workers, for metrics
+     */
+    [[nodiscard]] Stats getStats() const;
+
+private:
+    void push(std::function<void()> task);
+
+    /**
+     * Take the next task for a worker from its own queue, then the shared one, then the others
+     */
+    bool take(std::size_t worker, std::function<void()>& task);
+    [[nodiscard]] bool isWorker() const;
+    void work(std::size_t worker);
+};
+
+template <class F>
+std::future<std::invoke_result_t<F>> ThreadPool::submit(F&& task) {
+    using Result = std::invoke_result_t<F>;
+
+    // std::function needs to be copyable so the packaged task is shared
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    auto future = packaged->get_future();
+
+    push([packaged]() { (*packaged)(); });
+    return future;
+}
+
+
+#endif //SLINGER_THREAD_POOL_H
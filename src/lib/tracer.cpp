@@ -0,0 +1,231 @@
+//
+// Created by derek on 22/11/20.
+//
+
+#include "tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+std::atomic<bool> Tracer::enabled_ { false };
+
+const std::size_t Tracer::EVENTS_PER_THREAD = 1u << 16u;
+
+namespace {
+    const auto EPOCH = std::chrono::steady_clock::now();
+
+    std::string quote(const std::string &value) {
+        std::string quoted = "\"";
+
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+            }
+
+            quoted += (unsigned char) c < 0x20 ? ' ' : c;
+        }
+
+        return quoted + "\"";
+    }
+
+    struct Zone {
+        const char* name;
+        std::uint64_t start;
+        std::uint64_t end;
+    };
+
+    // Written by the owning thread while a dump may be copying it, so every field is atomic
+    struct Slot {
+        std::atomic<const char*> name { nullptr };
+        std::atomic<std::uint64_t> start { 0 };
+        std::atomic<std::uint64_t> end { 0 };
+    };
+}
+
+struct Tracer::ThreadBuffer {
+    // Only allocated once the thread records something, naming a thread doesn't need it
+    std::unique_ptr<Slot[]> zones;
+
+    // Only the owning thread writes zones, everything before written has been published
+    std::atomic<std::uint64_t> written { 0 };
+    std::atomic<std::uint64_t> clearedAt { 0 };
+
+    std::uint32_t id = 0;
+    std::string name;
+
+    // Set once the thread has finished, so the next thread to start can take the buffer over
+    bool retired = false;
+};
+
+// Hands the buffer back when its thread finishes
+struct Tracer::BufferOwner {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~BufferOwner() {
+        if (buffer) {
+            std::lock_guard lock(buffersMutex());
+            buffer->retired = true;
+        }
+    }
+};
+
+void Tracer::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::setThreadName(const std::string &name) {
+    auto &buffer = threadBuffer();
+
+    std::lock_guard lock(buffersMutex());
+    buffer.name = name;
+}
+
+void Tracer::record(const char *name, std::uint64_t start, std::uint64_t end) {
+    auto &buffer = threadBuffer();
+    auto index = buffer.written.load(std::memory_order_relaxed);
+
+    if (!buffer.zones) {
+        buffer.zones.reset(new Slot[EVENTS_PER_THREAD]);
+    }
+
+    // Keeps the slot from being overwritten before the last zone is published, so a dump that
+    // copies any part of the new zone also sees written up to this index
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto &slot = buffer.zones[index % EVENTS_PER_THREAD];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+std::uint64_t Tracer::now() {
+    auto elapsed = std::chrono::steady_clock::now() - EPOCH;
+    return (std::uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void Tracer::clear() {
+    std::lock_guard lock(buffersMutex());
+
+    for (auto &buffer : buffers()) {
+        buffer->clearedAt.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+void Tracer::dump(std::ostream &stream) {
+    std::lock_guard lock(buffersMutex());
+
+    // Timestamps are in microseconds, keep them to the nanosecond without touching the caller's stream
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+
+    out << R"({"displayTimeUnit":"ms","traceEvents":[)";
+    bool first = true;
+
+    auto separate = [&out, &first]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    std::vector<Zone> zones;
+
+    for (const auto &buffer : buffers()) {
+        if (!buffer->name.empty()) {
+            separate();
+            out << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->id
+                << R"(,"args":{"name":)" << quote(buffer->name) << "}}";
+        }
+
+        auto written = buffer->written.load(std::memory_order_acquire);
+        auto from = buffer->clearedAt.load(std::memory_order_relaxed);
+        if (written > EVENTS_PER_THREAD) {
+            from = std::max(from, written - EVENTS_PER_THREAD);
+        }
+
+        zones.clear();
+        for (auto i = from; i < written; i++) {
+            const auto &slot = buffer->zones[i % EVENTS_PER_THREAD];
+            zones.push_back(Zone {
+                slot.name.load(std::memory_order_relaxed),
+                slot.start.load(std::memory_order_relaxed),
+                slot.end.load(std::memory_order_relaxed)
+            });
+        }
+
+        // The owning thread may have carried on while the zones were copied. Anything it could
+        // have lapped since, including the slot it may be part way through, is dropped.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto rewritten = buffer->written.load(std::memory_order_relaxed);
+        auto valid = rewritten + 1 > EVENTS_PER_THREAD ? rewritten + 1 - EVENTS_PER_THREAD : 0;
+
+        for (auto i = std::max(from, valid); i < written; i++) {
+            const auto &zone = zones[i - from];
+
+            separate();
+            out << R"({"name":)" << quote(zone.name)
+                << R"(,"ph":"X","pid":1,"tid":)" << buffer->id
+                << R"(,"ts":)" << (double) zone.start / 1000.0
+                << R"(,"dur":)" << (double) (zone.end - zone.start) / 1000.0 << "}";
+        }
+    }
+
+    out << "\n]}\n";
+    stream << out.str();
+}
+
+void Tracer::dump(const std::string &path) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Could not open " + path + " to write a trace to");
+    }
+
+    dump(out);
+}
+
+Tracer::ThreadBuffer &Tracer::threadBuffer() {
+    thread_local BufferOwner owner;
+
+    if (!owner.buffer) {
+        std::lock_guard lock(buffersMutex());
+
+        // Reusing the buffer of a finished thread keeps memory to one buffer per running thread,
+        // its zones are dumped until the new thread takes it over
+        for (auto &buffer : buffers()) {
+            if (buffer->retired) {
+                buffer->retired = false;
+                buffer->name.clear();
+                buffer->clearedAt.store(buffer->written.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                owner.buffer = buffer;
+                break;
+            }
+        }
+
+        if (!owner.buffer) {
+            owner.buffer = std::make_shared<ThreadBuffer>();
+            owner.buffer->id = (std::uint32_t) buffers().size();
+            buffers().push_back(owner.buffer);
+        }
+    }
+
+    return *owner.buffer;
+}
+
+std::mutex &Tracer::buffersMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<std::shared_ptr<Tracer::ThreadBuffer>> &Tracer::buffers() {
+    // Buffers outlive their threads so zones from finished threads can still be dumped, until
+    // another thread starts and reuses them
+    static std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    return buffers;
+}
@@ -0,0 +1,119 @@
+//
+// Created by derek on 22/11/20.
+//
+
+#ifndef SLINGER_TRACER_H
+#define SLINGER_TRACER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "alloc_tracker.h"
+
+/**
+ * Records how long named zones of code take on every thread, and writes them out in the Chrome
+ * trace event format so they can be opened in chrome://tracing or Perfetto.
+ *
+ * Each thread writes into a ring buffer of its own, so recording never takes a lock. While
+ * tracing is disabled a zone only costs a relaxed load of the enabled flag.
+ */
+class Tracer {
+    static std::atomic<bool> enabled_;
+
+public:
+    // Each thread keeps this many of its latest zones
+    static const std::size_t EVENTS_PER_THREAD;
+
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Name the calling thread in the trace
+     */
+    static void setThreadName(const std::string& name);
+
+    /**
+     * Record a zone on the calling thread
+     * @param name has to outlive the tracer, zones are named with string literals
+     */
+    static void record(const char* name, std::uint64_t start, std::uint64_t end);
+
+    /**
+     * Nanoseconds since the tracer started
+     */
+    static std::uint64_t now();
+
+    /**
+     * Forget every zone recorded so far
+     */
+    static void clear();
+
+    static void dump(std::ostream& out);
+    static void dump(const std::string& path);
+
+private:
+    struct ThreadBuffer;
+    struct BufferOwner;
+    static ThreadBuffer& threadBuffer();
+    static std::mutex& buffersMutex();
+    static std::vector<std::shared_ptr<ThreadBuffer>>& buffers();
+};
+
+/**
+ * Records the time from its construction to its destruction as a zone, if tracing is enabled
+ * when it is constructed. With allocation tracking built in, allocations made inside the zone
+ * are also counted against it.
+ */
+class TraceZone {
+    const char* name_;
+    std::uint64_t start_ = 0;
+
+#ifdef SLINGER_ALLOC_TRACKING
+    const char* outerSystem_;
+#endif
+
+public:
+    explicit TraceZone(const char* name): name_(Tracer::isEnabled() ? name : nullptr) {
+#ifdef SLINGER_ALLOC_TRACKING
+        outerSystem_ = AllocTracker::enter(name);
+#endif
+
+        if (name_) {
+            start_ = Tracer::now();
+        }
+    }
+
+    ~TraceZone() {
+        if (name_) {
+            Tracer::record(name_, start_, Tracer::now());
+        }
+
+#ifdef SLINGER_ALLOC_TRACKING
+        AllocTracker::leave(outerSystem_);
+#endif
+    }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+};
+
+#define SLINGER_TRACE_CONCAT_(lhs, rhs) lhs##rhs
+#define SLINGER_TRACE_CONCAT(lhs, rhs) SLINGER_TRACE_CONCAT_(lhs, rhs)
+
+// Trace the rest of the enclosing scope, compiled out entirely unless SLINGER_TRACING or
+// SLINGER_ALLOC_TRACKING is set
+#if defined(SLINGER_TRACING) || defined(SLINGER_ALLOC_TRACKING)
+#define SLINGER_TRACE(name) TraceZone SLINGER_TRACE_CONCAT(traceZone, __LINE__)(name)
+#else
+#define SLINGER_TRACE(name) ((void) 0)
+#endif
+
+#endif //SLINGER_TRACER_H
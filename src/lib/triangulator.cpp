@@ -0,0 +1,326 @@
+//
+// Created by derek on 05/11/20.
+//
+
+#include "triangulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    float cross(const sf::Vector2f &o, const sf::Vector2f &a, const sf::Vector2f &b) {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    }
+
+    bool inTriangle(const sf::Vector2f &p, const sf::Vector2f &a, const sf::Vector2f &b, const sf::Vector2f &c) {
+        float d1 = cross(a, b, p);
+        float d2 = cross(b, c, p);
+        float d3 = cross(c, a, p);
+
+        bool negative = d1 < 0 || d2 < 0 || d3 < 0;
+        bool positive = d1 > 0 || d2 > 0 || d3 > 0;
+
+        return !(negative && positive);
+    }
+}
+
+Mesh Triangulator::triangulate(const Contour &outline, const std::vector<Contour> &holes) {
+    Mesh mesh;
+
+    mesh.vertices = clean(outline);
+    if (mesh.vertices.size() < 3) {
+        return Mesh {};
+    }
+
+    // Ear clipping expects the outline to wind anti-clockwise and the holes clockwise
+    if (signedArea(mesh.vertices) < 0) {
+        std::reverse(mesh.vertices.begin(), mesh.vertices.end());
+    }
+
+    std::vector<std::uint32_t> polygon;
+    for (std::uint32_t i = 0; i < mesh.vertices.size(); i++) {
+        polygon.push_back(i);
+    }
+
+    std::vector<Hole> holeInfo;
+    for (const auto &hole : holes) {
+        auto points = clean(hole);
+        if (points.size() < 3) {
+            continue;
+        }
+
+        if (signedArea(points) > 0) {
+            std::reverse(points.begin(), points.end());
+        }
+
+        auto rightmost = std::max_element(points.begin(), points.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.x < rhs.x;
+        });
+
+        Hole info {
+            mesh.vertices.size(),
+            points.size(),
+            mesh.vertices.size() + (std::size_t) (rightmost - points.begin())
+        };
+        mesh.vertices.insert(mesh.vertices.end(), points.begin(), points.end());
+
+        holeInfo.push_back(info);
+    }
+
+    // Join holes to the outline from right to left so each bridge can only cross holes that
+    // have already been merged
+    std::sort(holeInfo.begin(), holeInfo.end(), [&mesh](const Hole &lhs, const Hole &rhs) {
+        return mesh.vertices[lhs.rightmost].x > mesh.vertices[rhs.rightmost].x;
+    });
+
+    for (const auto &hole : holeInfo) {
+        bridge(mesh.vertices, polygon, hole);
+    }
+
+    clipEars(mesh.vertices, std::move(polygon), mesh.indices);
+
+    return mesh;
+}
+
+Mesh Triangulator::triangulate(const std::vector<Contour> &contours) {
+    const auto none = contours.size();
+    std::vector<std::size_t> depth(contours.size(), 0);
+    std::vector<std::size_t> parent(contours.size(), none);
+
+    // Sub-paths of one path don't cross, so a contour is inside another if any of its points is.
+    // The smallest contour around one is the one it sits directly inside.
+    for (std::size_t i = 0; i < contours.size(); i++) {
+        if (contours[i].empty()) {
+            continue;
+        }
+
+        for (std::size_t j = 0; j < contours.size(); j++) {
+            if (i == j || contours[j].size() < 3 || !contains(contours[j], contours[i].front())) {
+                continue;
+            }
+
+            depth[i]++;
+            if (parent[i] == none || std::abs(signedArea(contours[j])) < std::abs(signedArea(contours[parent[i]]))) {
+                parent[i] = j;
+            }
+        }
+    }
+
+    Mesh mesh;
+
+    for (std::size_t i = 0; i < contours.size(); i++) {
+        if (depth[i] % 2 != 0) {
+            continue;
+        }
+
+        std::vector<Contour> holes;
+        for (std::size_t j = 0; j < contours.size(); j++) {
+            if (parent[j] == i && depth[j] == depth[i] + 1) {
+                holes.push_back(contours[j]);
+            }
+        }
+
+        auto part = triangulate(contours[i], holes);
+        const auto offset = (std::uint32_t) mesh.vertices.size();
+
+        mesh.vertices.insert(mesh.vertices.end(), part.vertices.begin(), part.vertices.end());
+        for (auto index : part.indices) {
+            mesh.indices.push_back(offset + index);
+        }
+    }
+
+    return mesh;
+}
+
+float Triangulator::signedArea(const Contour &contour) {
+    float area = 0;
+
+    for (std::size_t i = 0, j = contour.size() - 1; i < contour.size(); j = i++) {
+        area += (contour[j].x - contour[i].x) * (contour[j].y + contour[i].y);
+    }
+
+    return area / 2.f;
+}
+
+bool Triangulator::contains(const Contour &contour, const sf::Vector2f &point) {
+    bool inside = false;
+
+    for (std::size_t i = 0, j = contour.size() - 1; i < contour.size(); j = i++) {
+        const auto &a = contour[i];
+        const auto &b = contour[j];
+
+        if ((a.y > point.y) != (b.y > point.y) && point.x < a.x + (point.y - a.y) * (b.x - a.x) / (b.y - a.y)) {
+            inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+Triangulator::Contour Triangulator::clean(const Contour &contour) {
+    Contour points;
+
+    for (const auto &point : contour) {
+        if (points.empty() || points.back() != point) {
+            points.push_back(point);
+        }
+    }
+
+    // Svg paths repeat the first point to close the shape
+    while (points.size() > 1 && points.front() == points.back()) {
+        points.pop_back();
+    }
+
+    return points;
+}
+
+void Triangulator::bridge(
+    const std::vector<sf::Vector2f> &vertices,
+    std::vector<std::uint32_t> &polygon,
+    const Hole &hole
+) {
+    const auto &m = vertices[hole.rightmost];
+
+    // Cast a ray to the right of the hole and find the closest edge it hits
+    float closestX = std::numeric_limits<float>::max();
+    std::size_t edge = polygon.size();
+
+    for (std::size_t i = 0; i < polygon.size(); i++) {
+        const auto &a = vertices[polygon[i]];
+        const auto &b = vertices[polygon[(i + 1) % polygon.size()]];
+
+        if (a.y == b.y || (a.y > m.y) == (b.y > m.y)) {
+            continue;
+        }
+
+        float x = a.x + (m.y - a.y) * (b.x - a.x) / (b.y - a.y);
+        if (x >= m.x && x < closestX) {
+            closestX = x;
+            edge = i;
+        }
+    }
+
+    std::size_t target = 0;
+
+    if (edge == polygon.size()) {
+        // Nothing to the right, the hole isn't inside the outline so join to the nearest point
+        float closest = std::numeric_limits<float>::max();
+        for (std::size_t i = 0; i < polygon.size(); i++) {
+            auto d = vertices[polygon[i]] - m;
+            if (d.x * d.x + d.y * d.y < closest) {
+                closest = d.x * d.x + d.y * d.y;
+                target = i;
+            }
+        }
+    } else {
+        std::size_t next = (edge + 1) % polygon.size();
+        target = vertices[polygon[edge]].x > vertices[polygon[next]].x ? edge : next;
+
+        // A reflex vertex inside the triangle made by the hole, the hit point and the candidate
+        // would block the bridge, if there are any use the one closest in angle to the ray
+        sf::Vector2f hit(closestX, m.y);
+        const auto candidate = vertices[polygon[target]];
+        float bestAngle = std::numeric_limits<float>::max();
+
+        for (std::size_t i = 0; i < polygon.size(); i++) {
+            const auto &p = vertices[polygon[i]];
+            const auto &prev = vertices[polygon[(i + polygon.size() - 1) % polygon.size()]];
+            const auto &next = vertices[polygon[(i + 1) % polygon.size()]];
+
+            if (i == target || p.x < m.x || cross(prev, p, next) > 0 || !inTriangle(p, m, hit, candidate)) {
+                continue;
+            }
+
+            float angle = std::atan2(std::abs(p.y - m.y), p.x - m.x);
+            if (angle < bestAngle) {
+                bestAngle = angle;
+                target = i;
+            }
+        }
+    }
+
+    // Walk out to the hole, all the way around it and back again along the same bridge
+    std::vector<std::uint32_t> merged;
+    merged.reserve(polygon.size() + hole.size + 2);
+    merged.insert(merged.end(), polygon.begin(), polygon.begin() + (long) target + 1);
+
+    for (std::size_t i = 0; i <= hole.size; i++) {
+        merged.push_back(hole.start + (hole.rightmost - hole.start + i) % hole.size);
+    }
+
+    merged.insert(merged.end(), polygon.begin() + (long) target, polygon.end());
+    polygon = std::move(merged);
+}
+
+void Triangulator::clipEars(
+    const std::vector<sf::Vector2f> &vertices,
+    std::vector<std::uint32_t> polygon,
+    std::vector<std::uint32_t> &indices
+) {
+    indices.reserve((polygon.size() - 2) * 3);
+
+    std::size_t i = 0;
+    std::size_t attempts = 0;
+
+    while (polygon.size() > 3) {
+        const auto size = polygon.size();
+        i %= size;
+
+        bool ear = isEar(vertices, polygon, i);
+
+        // If a whole lap finds no ears the polygon is degenerate, clip anyway so we always finish
+        if (!ear && ++attempts < size) {
+            i++;
+            continue;
+        }
+
+        auto prev = polygon[(i + size - 1) % size];
+        auto next = polygon[(i + 1) % size];
+
+        if (cross(vertices[prev], vertices[polygon[i]], vertices[next]) > 0) {
+            indices.insert(indices.end(), { prev, polygon[i], next });
+        }
+
+        polygon.erase(polygon.begin() + (long) i);
+        attempts = 0;
+
+        // Step back so the previous vertex, which may have just become an ear, is checked next
+        i = (i + size - 2) % (size - 1);
+    }
+
+    if (polygon.size() == 3 && cross(vertices[polygon[0]], vertices[polygon[1]], vertices[polygon[2]]) > 0) {
+        indices.insert(indices.end(), { polygon[0], polygon[1], polygon[2] });
+    }
+}
+
+bool Triangulator::isEar(
+    const std::vector<sf::Vector2f> &vertices,
+    const std::vector<std::uint32_t> &polygon,
+    std::size_t i
+) {
+    const auto size = polygon.size();
+    const auto &a = vertices[polygon[(i + size - 1) % size]];
+    const auto &b = vertices[polygon[i]];
+    const auto &c = vertices[polygon[(i + 1) % size]];
+
+    // Reflex corners can't be ears
+    if (cross(a, b, c) <= 0) {
+        return false;
+    }
+
+    for (std::size_t j = 0; j < size; j++) {
+        const auto &p = vertices[polygon[j]];
+
+        // Bridged holes share positions with the corners so compare by value
+        if (p == a || p == b || p == c) {
+            continue;
+        }
+
+        if (inTriangle(p, a, b, c)) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,64 @@
+//
+// Created by derek on 05/11/20.
+//
+
+#ifndef SLINGER_TRIANGULATOR_H
+#define SLINGER_TRIANGULATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+/**
+ * An indexed triangle list, every three indices make up a triangle
+ */
+struct Mesh {
+    std::vector<sf::Vector2f> vertices;
+    std::vector<std::uint32_t> indices;
+};
+
+/**
+ * Splits arbitrary simple polygons, concave or with holes, into triangles by ear clipping
+ */
+class Triangulator {
+public:
+    using Contour = std::vector<sf::Vector2f>;
+
+    /**
+     * Triangulate a polygon, the winding of the contours doesn't matter
+     * @param outline the outer boundary of the polygon
+     * @param holes contours inside the outline to leave empty
+     * @return the triangles covering the polygon
+     */
+    static Mesh triangulate(const Contour& outline, const std::vector<Contour>& holes = {});
+
+    /**
+     * Triangulate a list of contours, like the sub-paths of an svg path, by how they nest.
+     * Contours inside an even number of others are outlines, each triangulated with the holes
+     * directly inside it, so separate islands stay separate.
+     */
+    static Mesh triangulate(const std::vector<Contour>& contours);
+
+    static float signedArea(const Contour& contour);
+
+    /**
+     * Whether a point is inside a contour, by the even-odd rule
+     */
+    static bool contains(const Contour& contour, const sf::Vector2f& point);
+
+private:
+    struct Hole {
+        std::size_t start;
+        std::size_t size;
+        std::size_t rightmost;
+    };
+
+    static Contour clean(const Contour& contour);
+    static void bridge(const std::vector<sf::Vector2f>& vertices, std::vector<std::uint32_t>& polygon, const Hole& hole);
+    static void clipEars(const std::vector<sf::Vector2f>& vertices, std::vector<std::uint32_t> polygon, std::vector<std::uint32_t>& indices);
+    static bool isEar(const std::vector<sf::Vector2f>& vertices, const std::vector<std::uint32_t>& polygon, std::size_t i);
+};
+
+
+#endif //SLINGER_TRIANGULATOR_H
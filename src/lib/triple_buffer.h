@@ -0,0 +1,84 @@
+//
+// Created by derek on 28/11/20.
+//
+
+#ifndef SLINGER_TRIPLE_BUFFER_H
+#define SLINGER_TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Hands values from one writing thread to one reading thread without either waiting on the
+ * other. The writer fills the back buffer and publishes it, the reader picks up whatever was
+ * published last, skipping anything it was too slow to see.
+ */
+template <class T>
+class TripleBuffer {
+    // The buffer between the writer and the reader is kept in the low bits, FRESH is set while
+    // it holds something the reader hasn't picked up
+    static constexpr std::uint8_t INDEX_MASK = 0b011;
+    static constexpr std::uint8_t FRESH = 0b100;
+
+    std::array<T, 3> buffers_;
+    std::atomic<std::uint8_t> middle_ {1};
+
+    // Each only touched by its own thread
+    std::uint8_t back_ = 0;
+    std::uint8_t front_ = 2;
+
+public:
+    /**
+     * The buffer for the writer to fill, it holds whatever was last swapped out so overwrite
+     * every part of it
+     */
+    T& back() {
+        return buffers_[back_];
+    }
+
+    /**
+     * Hand the back buffer over to the reader, waking it if it is waiting
+     */
+    void publish() {
+        auto previous = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel);
+        back_ = previous & INDEX_MASK;
+        middle_.notify_one();
+    }
+
+    /**
+     * Move the latest published value to the front
+     * @return whether there was one the reader hadn't seen yet
+     */
+    bool update() {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+
+        auto previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * Block the reader until something it hasn't seen is published
+     */
+    void wait() const {
+        auto state = middle_.load(std::memory_order_acquire);
+
+        while (!(state & FRESH)) {
+            middle_.wait(state, std::memory_order_acquire);
+            state = middle_.load(std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * The value the reader is working with, left alone by the writer until the next update
+     */
+    const T& front() const {
+        return buffers_[front_];
+    }
+};
+
+
+#endif //SLINGER_TRIPLE_BUFFER_H
@@ -8,6 +8,7 @@
 #include <SFML/Graphics.hpp>
 #include <entt/entt.hpp>
 #include <level_scene.h>
+#include <logging.h>
 #include <scenes/main_menu_scene.h>
 #include <scenes/scene_manager.h>
 
@@ -31,8 +32,8 @@ std::optional<std::string> getMap(int argc, char *argv[]) {
 }
 
 int main(int argc, char *argv[]) {
-    spdlog::set_level(spdlog::level::debug);
-    spdlog::set_pattern("%Y-%m-%d %! [%l] %v");
+    // Log on a background thread so writing to the console never holds up a frame
+    Logging::init(Logging::Overflow::DROP, spdlog::level::info);
 
     auto mapPath = getMap(argc, argv);
     SPDLOG_INFO("Starting game, using map: {}", mapPath.value_or("No map found"));
@@ -45,7 +46,11 @@ int main(int argc, char *argv[]) {
     );
     window.setKeyRepeatEnabled(false);
 
-    SceneManager manager(window, mapPath);
-    manager.run();
+    {
+        SceneManager manager(window, mapPath);
+        manager.run();
+    }
+
+    Logging::shutdown();
 }
 
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "alloc_tracker.h"
+
+namespace {
+    const AllocTracker::SystemAllocations* find(const AllocTracker::FrameReport &report, const char *name) {
+        auto it = std::find_if(report.systems.begin(), report.systems.end(), [name](const auto &system) {
+            return std::strcmp(system.name, name) == 0;
+        });
+
+        return it != report.systems.end() ? &*it : nullptr;
+    }
+}
+
+TEST(AllocTracker, AttributesAllocationsToTheCurrentSystem) {
+    AllocTracker::setEnabled(true);
+    AllocTracker::endFrame();
+
+    auto *outer = AllocTracker::enter("test physics");
+    AllocTracker::record(16);
+    AllocTracker::record(32);
+
+    auto *physics = AllocTracker::enter("test rope");
+    AllocTracker::record(100);
+    AllocTracker::leave(physics);
+
+    AllocTracker::record(8);
+    AllocTracker::leave(outer);
+
+    auto report = AllocTracker::endFrame();
+    AllocTracker::setEnabled(AllocTracker::isAvailable());
+
+    const auto *physicsAllocations = find(report, "test physics");
+    ASSERT_NE(physicsAllocations, nullptr);
+    EXPECT_EQ(physicsAllocations->allocations, 3);
+    EXPECT_EQ(physicsAllocations->bytes, 56);
+
+    const auto *ropeAllocations = find(report, "test rope");
+    ASSERT_NE(ropeAllocations, nullptr);
+    EXPECT_EQ(ropeAllocations->allocations, 1);
+    EXPECT_EQ(ropeAllocations->bytes, 100);
+}
+
+TEST(AllocTracker, StartsEachFrameFromNothing) {
+    AllocTracker::setEnabled(true);
+
+    auto *outer = AllocTracker::enter("test frame");
+    AllocTracker::record(64);
+    AllocTracker::leave(outer);
+    AllocTracker::endFrame();
+
+    auto report = AllocTracker::endFrame();
+    AllocTracker::setEnabled(AllocTracker::isAvailable());
+
+    // Systems stay in the report so a quiet frame still shows up as zero
+    const auto *system = find(report, "test frame");
+    ASSERT_NE(system, nullptr);
+    EXPECT_EQ(system->allocations, 0);
+    EXPECT_EQ(system->bytes, 0);
+}
+
+TEST(AllocTracker, IgnoresAllocationsWhilePausedOrDisabled) {
+    AllocTracker::setEnabled(true);
+    AllocTracker::endFrame();
+
+    auto *outer = AllocTracker::enter("test paused");
+    {
+        AllocPause pause;
+        AllocTracker::record(64);
+    }
+
+    AllocTracker::setEnabled(false);
+    AllocTracker::record(64);
+    AllocTracker::setEnabled(true);
+
+    AllocTracker::record(1);
+    AllocTracker::leave(outer);
+
+    auto report = AllocTracker::endFrame();
+    AllocTracker::setEnabled(AllocTracker::isAvailable());
+
+    const auto *system = find(report, "test paused");
+    ASSERT_NE(system, nullptr);
+    EXPECT_EQ(system->allocations, 1);
+    EXPECT_EQ(system->bytes, 1);
+}
+
+TEST(AllocTracker, MergesSystemsWithTheSameName) {
+    static const char first[] = "test merged";
+    static const char second[] = "test merged";
+    ASSERT_NE((const void *) first, (const void *) second);
+
+    AllocTracker::setEnabled(true);
+    AllocTracker::endFrame();
+
+    auto *outer = AllocTracker::enter(first);
+    AllocTracker::record(10);
+    AllocTracker::enter(second);
+    AllocTracker::record(20);
+    AllocTracker::leave(outer);
+
+    auto report = AllocTracker::endFrame();
+    AllocTracker::setEnabled(AllocTracker::isAvailable());
+
+    auto count = std::count_if(report.systems.begin(), report.systems.end(), [](const auto &system) {
+        return std::strcmp(system.name, "test merged") == 0;
+    });
+    EXPECT_EQ(count, 1);
+
+    const auto *system = find(report, "test merged");
+    ASSERT_NE(system, nullptr);
+    EXPECT_EQ(system->allocations, 2);
+    EXPECT_EQ(system->bytes, 30);
+}
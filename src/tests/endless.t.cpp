@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+#include <entt/entt.hpp>
+
+#include "endless_generator.h"
+#include "endless_map.h"
+#include "map_maker.h"
+
+namespace {
+    bool onGrid(float value) {
+        float cells = value / EndlessGenerator::GRID;
+        return std::abs(cells - std::round(cells)) < 0.001f;
+    }
+
+    bool sameShape(const LevelShape &lhs, const LevelShape &rhs) {
+        return lhs.rect.x == rhs.rect.x && lhs.rect.y == rhs.rect.y &&
+            lhs.rect.width == rhs.rect.width && lhs.rect.height == rhs.rect.height;
+    }
+
+    std::size_t countBodies(entt::registry &registry) {
+        return registry.view<BodyPtr>().size();
+    }
+
+    sf::Vector2f inChunk(std::size_t index) {
+        return sf::Vector2f(0, ((float) index + 0.5f) * EndlessGenerator::CHUNK_HEIGHT);
+    }
+}
+
+TEST(EndlessGenerator, SameSeedMakesSameChunk) {
+    EndlessGenerator first(1234);
+    EndlessGenerator second(1234);
+
+    // Generating out of order shouldn't matter
+    (void) second.generate(7);
+    auto lhs = first.generate(3);
+    auto rhs = second.generate(3);
+
+    ASSERT_EQ(lhs.walls.size(), rhs.walls.size());
+    for (std::size_t i = 0; i < lhs.walls.size(); i++) {
+        EXPECT_TRUE(sameShape(lhs.walls[i], rhs.walls[i]));
+    }
+
+    ASSERT_EQ(lhs.deathZones.size(), rhs.deathZones.size());
+    for (std::size_t i = 0; i < lhs.deathZones.size(); i++) {
+        EXPECT_TRUE(sameShape(lhs.deathZones[i].shape, rhs.deathZones[i].shape));
+    }
+}
+
+TEST(EndlessGenerator, DifferentSeedsMakeDifferentChunks) {
+    auto lhs = EndlessGenerator(1).generate(2);
+    auto rhs = EndlessGenerator(2).generate(2);
+
+    bool different = lhs.walls.size() != rhs.walls.size();
+    for (std::size_t i = 0; !different && i < lhs.walls.size(); i++) {
+        different = !sameShape(lhs.walls[i], rhs.walls[i]);
+    }
+
+    EXPECT_TRUE(different);
+}
+
+TEST(EndlessGenerator, ChunksStayInsideTheirBounds) {
+    EndlessGenerator generator(42);
+    const float halfWidth = EndlessGenerator::CHUNK_WIDTH / 2.f + EndlessGenerator::WALL_THICKNESS;
+
+    for (std::size_t index = 1; index < 50; index++) {
+        auto chunk = generator.generate(index);
+        auto bottom = (float) index * EndlessGenerator::CHUNK_HEIGHT;
+        auto top = bottom + EndlessGenerator::CHUNK_HEIGHT;
+
+        ASSERT_EQ(chunk.checkpoints.size(), 1);
+        EXPECT_FALSE(chunk.checkpoints[0].finish);
+
+        for (const auto &wall : chunk.walls) {
+            const auto &rect = wall.rect;
+            EXPECT_GE(rect.x - rect.width / 2.f, -halfWidth - 0.001f);
+            EXPECT_LE(rect.x + rect.width / 2.f, halfWidth + 0.001f);
+            EXPECT_GE(rect.y - rect.height / 2.f, bottom - 0.001f);
+            EXPECT_LE(rect.y + rect.height / 2.f, top + 0.001f);
+        }
+    }
+}
+
+TEST(EndlessGenerator, OnlyMakesAFewDistinctSizes) {
+    EndlessGenerator generator(99);
+    std::set<std::pair<float, float>> sizes;
+
+    for (std::size_t index = 0; index < 200; index++) {
+        for (const auto &wall : generator.generate(index).walls) {
+            EXPECT_TRUE(onGrid(wall.rect.width));
+            EXPECT_TRUE(onGrid(wall.rect.height));
+            sizes.emplace(wall.rect.width, wall.rect.height);
+        }
+    }
+
+    // Each size is a separate mesh in the cache, so this has to stay bounded for long climbs
+    EXPECT_LT(sizes.size(), 20);
+}
+
+TEST(EndlessGenerator, FindsChunkForHeight) {
+    EXPECT_EQ(EndlessGenerator::chunkAt(-5), 0);
+    EXPECT_EQ(EndlessGenerator::chunkAt(1), 0);
+    EXPECT_EQ(EndlessGenerator::chunkAt(EndlessGenerator::CHUNK_HEIGHT * 3 + 1), 3);
+}
+
+TEST(EndlessMap, RetiresChunksBelowTheRespawn) {
+    entt::registry registry;
+    entt::dispatcher dispatcher;
+    Physics physics(registry, dispatcher);
+    MapShapeBuilder builder(registry, physics);
+    EndlessMap map(registry, physics, builder);
+
+    const std::uint32_t seed = 7;
+    const std::size_t kept = EndlessMap::CHUNKS_BEHIND + EndlessMap::CHUNKS_AHEAD + 1;
+
+    // The most bodies any run of kept chunks can have, plus the kill floor
+    std::size_t mostShapes = 0;
+    EndlessGenerator generator(seed);
+    for (std::size_t index = 0; index < 40; index++) {
+        auto chunk = generator.generate(index);
+        mostShapes = std::max(mostShapes, chunk.walls.size() + chunk.deathZones.size() + chunk.checkpoints.size());
+    }
+
+    map.start(seed);
+
+    // Without a pool each update adds at most one chunk, so a couple per chunk climbed keeps up
+    for (std::size_t index = 0; index < 30; index++) {
+        map.update(inChunk(index), inChunk(index));
+        map.update(inChunk(index), inChunk(index));
+
+        EXPECT_LE(map.chunkCount(), kept);
+        EXPECT_LE(countBodies(registry), mostShapes * kept + 1);
+        EXPECT_EQ(physics.getWorld().GetBodyCount(), (int) countBodies(registry));
+    }
+
+    // A checkpoint left far below keeps every chunk above it
+    map.start(seed);
+    for (std::size_t index = 0; index < 10; index++) {
+        map.update(inChunk(index), inChunk(0));
+        map.update(inChunk(index), inChunk(0));
+    }
+
+    EXPECT_GT(map.chunkCount(), kept);
+}
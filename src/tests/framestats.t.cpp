@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "frame_stats.h"
+
+TEST(FrameStats, FindsPercentilesOfRecentFrames) {
+    FrameStats stats;
+
+    for (int i = 1; i <= 100; i++) {
+        stats.endFrame((float) i);
+    }
+
+    EXPECT_FLOAT_EQ(stats.percentile(0.5f), 50);
+    EXPECT_FLOAT_EQ(stats.percentile(0.95f), 95);
+    EXPECT_FLOAT_EQ(stats.percentile(0.99f), 99);
+    EXPECT_FLOAT_EQ(stats.percentile(1.f), 100);
+}
+
+TEST(FrameStats, OnlyKeepsTheWindow) {
+    FrameStats stats;
+
+    // A hitch long ago shouldn't show up once enough frames have passed
+    stats.endFrame(500);
+    for (std::size_t i = 0; i < FrameStats::WINDOW; i++) {
+        stats.endFrame(16);
+    }
+
+    EXPECT_FLOAT_EQ(stats.percentile(1.f), 16);
+    EXPECT_EQ(stats.frameCount(), FrameStats::WINDOW + 1);
+}
+
+TEST(FrameStats, AveragesSections) {
+    FrameStats stats;
+
+    stats.addSection(FrameStats::Section::PHYSICS, 2);
+    stats.addSection(FrameStats::Section::PHYSICS, 1);
+    stats.endFrame(16);
+
+    stats.addSection(FrameStats::Section::PHYSICS, 1);
+    stats.addSection(FrameStats::Section::DRAW, 4);
+    stats.endFrame(16);
+
+    // The frame in progress isn't counted until it ends
+    stats.addSection(FrameStats::Section::DRAW, 100);
+
+    EXPECT_FLOAT_EQ(stats.averageSection(FrameStats::Section::PHYSICS), 2);
+    EXPECT_FLOAT_EQ(stats.averageSection(FrameStats::Section::DRAW), 2);
+    EXPECT_FLOAT_EQ(stats.averageSection(FrameStats::Section::INPUT), 0);
+}
+
+TEST(FrameStats, BucketsFramesIntoHistogram) {
+    FrameStats stats;
+
+    stats.endFrame(1);
+    stats.endFrame(3);
+    stats.endFrame(3.5f);
+    stats.endFrame(1000);
+
+    auto histogram = stats.histogram();
+    ASSERT_EQ(histogram.size(), FrameStats::HISTOGRAM_BUCKETS);
+    EXPECT_EQ(histogram[0], 1);
+    EXPECT_EQ(histogram[1], 2);
+    EXPECT_EQ(histogram.back(), 1);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "level_analyzer.h"
+
+namespace {
+    const std::string LEVEL_SVG = R"(
+<svg xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape">
+  <g inkscape:label="walls">
+    <rect x="0" y="10" width="20" height="2" />
+    <path d="M 0,0 L 4,0 L 4,-4 L 2,-2 L 0,-4 Z" />
+    <path d="M 10,0 h 4 v 4 h -4 z" />
+  </g>
+  <g inkscape:label="death_zones">
+    <rect inkscape:label="spikes" x="30" y="10" width="5" height="1" />
+  </g>
+  <g inkscape:label="decorations">
+    <path d="M 0,0 H 10 V 10 H 0 Z" />
+  </g>
+  <g inkscape:label="objects">
+    <rect id="player" x="1" y="2" width="2" height="4" />
+  </g>
+</svg>
+)";
+
+    LevelReport analyzeLevel() {
+        return LevelAnalyzer::analyze(LEVEL_SVG.data(), LEVEL_SVG.size(), "test");
+    }
+}
+
+TEST(LevelAnalyzer, CountsEachLayer) {
+    auto report = analyzeLevel();
+    const auto &walls = report.layers.at("walls");
+
+    EXPECT_EQ(walls.shapes, 3);
+    EXPECT_EQ(walls.rects, 1);
+    EXPECT_EQ(walls.polygons, 2);
+    EXPECT_EQ(walls.bodies, 3);
+    EXPECT_EQ(walls.fixtures, 3);
+
+    // The notched polygon is concave so box2d hulls it, the square isn't, and neither has more
+    // vertices than box2d takes
+    EXPECT_EQ(walls.hulled, 1);
+    EXPECT_EQ(walls.overVertexLimit, 0);
+
+    EXPECT_EQ(report.layers.at("death_zones").bodies, 1);
+    EXPECT_EQ(report.layers.at("decorations").bodies, 0);
+    EXPECT_EQ(report.bodies, report.layers.at("objects").bodies + 4);
+    EXPECT_GE(report.proxies, report.fixtures);
+}
+
+TEST(LevelAnalyzer, CountsDrawablesByZIndex) {
+    auto report = analyzeLevel();
+    auto metrics = report.metrics();
+
+    std::size_t total = 0;
+    for (const auto &[zIndex, count] : report.drawablesPerZIndex) {
+        total += count;
+    }
+
+    EXPECT_EQ(metrics.at("drawables"), (double) total);
+    EXPECT_EQ(report.drawablesPerZIndex.at(1), 1);
+}
+
+TEST(LevelAnalyzer, FailsBudgetsThatAreExceeded) {
+    auto report = analyzeLevel();
+
+    EXPECT_TRUE(LevelAnalyzer::checkBudgets(report, { { "layers.walls.bodies", 3 } }).empty());
+    EXPECT_EQ(LevelAnalyzer::checkBudgets(report, { { "layers.walls.bodies", 2 } }).size(), 1);
+}
+
+TEST(LevelAnalyzer, FailsBudgetsForUnknownMetrics) {
+    auto report = analyzeLevel();
+
+    EXPECT_EQ(LevelAnalyzer::checkBudgets(report, { { "not_a_metric", 1 } }).size(), 1);
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "level_cooker.h"
+#include "level_reader.h"
+
+namespace {
+    const std::string LEVEL_SVG = R"(
+<svg xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape">
+  <g inkscape:label="walls">
+    <rect x="0" y="10" width="20" height="2" />
+    <path d="M 0,0 L 4,0 L 4,-4 L 2,-2 L 0,-4 Z" />
+  </g>
+  <g inkscape:label="death_zones">
+    <rect inkscape:label="spikes" x="30" y="10" width="5" height="1" />
+  </g>
+  <g inkscape:label="checkpoints">
+    <path inkscape:label="finish" d="M 40,0 h 2 v 2 h -2 z" />
+  </g>
+  <g inkscape:label="decorations">
+    <path d="M 0,0 H 10 V 10 H 0 Z m 2,2 h 2 v 2 h -2 z" />
+  </g>
+  <g inkscape:label="objects">
+    <rect id="player" x="1" y="2" width="2" height="4" />
+  </g>
+</svg>
+)";
+
+    const LevelCooker::Source SOURCE { 100, 5, 42 };
+
+    LevelData readLevel() {
+        return LevelReader::readBuffer(LEVEL_SVG.data(), LEVEL_SVG.size(), "test");
+    }
+}
+
+TEST(LevelCooker, CanReadLevel) {
+    auto level = readLevel();
+
+    EXPECT_EQ(level.spawn, sf::Vector2f(2, -4));
+
+    ASSERT_EQ(level.walls.size(), 2);
+    EXPECT_EQ(level.walls.at(0).type, LevelShape::Type::RECT);
+    EXPECT_EQ(level.walls.at(1).type, LevelShape::Type::POLYGON);
+    EXPECT_EQ(level.walls.at(1).polygon.mesh.indices.size(), 9);
+
+    ASSERT_EQ(level.deathZones.size(), 1);
+    EXPECT_TRUE(level.deathZones.at(0).spikes);
+
+    ASSERT_EQ(level.checkpoints.size(), 1);
+    EXPECT_TRUE(level.checkpoints.at(0).finish);
+
+    ASSERT_EQ(level.decorations.size(), 1);
+    EXPECT_EQ(level.decorations.at(0).polygon.detailLevels.size(), LevelReader::DECORATION_DETAIL_TOLERANCES.size());
+}
+
+TEST(LevelCooker, CanRoundTripLevel) {
+    auto level = readLevel();
+    auto cooked = LevelCooker::serialise(level, SOURCE);
+
+    auto loaded = LevelCooker::deserialise(cooked.data(), cooked.size(), SOURCE);
+    ASSERT_TRUE(loaded.has_value());
+
+    EXPECT_EQ(loaded->spawn, level.spawn);
+    ASSERT_EQ(loaded->walls.size(), level.walls.size());
+    EXPECT_EQ(loaded->walls.at(0).rect.width, 20);
+    EXPECT_EQ(loaded->walls.at(1).polygon.outline, level.walls.at(1).polygon.outline);
+    EXPECT_EQ(loaded->walls.at(1).polygon.mesh.indices, level.walls.at(1).polygon.mesh.indices);
+
+    ASSERT_EQ(loaded->deathZones.size(), 1);
+    EXPECT_TRUE(loaded->deathZones.at(0).spikes);
+    ASSERT_EQ(loaded->checkpoints.size(), 1);
+    EXPECT_TRUE(loaded->checkpoints.at(0).finish);
+
+    const auto &detail = loaded->decorations.at(0).polygon.detailLevels;
+    ASSERT_EQ(detail.size(), level.decorations.at(0).polygon.detailLevels.size());
+    EXPECT_EQ(detail.at(0).tolerance, level.decorations.at(0).polygon.detailLevels.at(0).tolerance);
+    EXPECT_EQ(detail.at(0).mesh.vertices, level.decorations.at(0).polygon.detailLevels.at(0).mesh.vertices);
+}
+
+TEST(LevelCooker, IgnoresStaleCook) {
+    auto cooked = LevelCooker::serialise(readLevel(), SOURCE);
+
+    EXPECT_FALSE(LevelCooker::deserialise(cooked.data(), cooked.size(), LevelCooker::Source { 101, 6, 43 }).has_value());
+    EXPECT_FALSE(LevelCooker::deserialise(cooked.data(), cooked.size(), LevelCooker::Source { 100, 6, 0 }).has_value());
+    EXPECT_FALSE(LevelCooker::deserialise("not a level", 11, SOURCE).has_value());
+}
+
+TEST(LevelCooker, MatchesSourceByTimeOrHash) {
+    auto cooked = LevelCooker::serialise(readLevel(), SOURCE);
+
+    // Untouched, before the svg has been read
+    EXPECT_TRUE(LevelCooker::deserialise(cooked.data(), cooked.size(), LevelCooker::Source { 100, 5, 0 }).has_value());
+
+    // Touched but not changed
+    EXPECT_TRUE(LevelCooker::deserialise(cooked.data(), cooked.size(), LevelCooker::Source { 100, 6, 42 }).has_value());
+}
+
+TEST(LevelCooker, ThrowsOnTruncatedCook) {
+    auto cooked = LevelCooker::serialise(readLevel(), SOURCE);
+
+    EXPECT_THROW(LevelCooker::deserialise(cooked.data(), cooked.size() - 1, SOURCE), std::runtime_error);
+}
+
+TEST(LevelCooker, OnlyCooksChangedLevels) {
+    auto directory = std::filesystem::temp_directory_path() / "slinger-levelcooker-test";
+    std::filesystem::create_directories(directory);
+    auto svgPath = (directory / "level.svg").string();
+
+    std::ofstream(svgPath) << LEVEL_SVG;
+    EXPECT_TRUE(LevelCooker::cook(svgPath));
+    EXPECT_FALSE(LevelCooker::cook(svgPath));
+
+    // Written again without changing
+    std::ofstream(svgPath) << LEVEL_SVG;
+    EXPECT_FALSE(LevelCooker::cook(svgPath));
+
+    std::ofstream(svgPath) << LEVEL_SVG << "\n";
+    EXPECT_TRUE(LevelCooker::cook(svgPath));
+    EXPECT_EQ(LevelCooker::load(svgPath).walls.size(), 2);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(LevelCooker, HashesContent) {
+    EXPECT_EQ(LevelCooker::hash("abc", 3), LevelCooker::hash("abc", 3));
+    EXPECT_NE(LevelCooker::hash("abc", 3), LevelCooker::hash("abd", 3));
+}
+
+TEST(LevelCooker, NamesCookNextToSvg) {
+    EXPECT_EQ(LevelCooker::cookedPath("data/levels/001-beginning.svg"), "data/levels/001-beginning.cooked");
+}
+
+TEST(LevelCooker, CooksPagesThatCanBeReadAlone) {
+    auto level = readLevel();
+    level.walls.push_back(level.walls.at(0));
+    level.walls.back().rect.y += LevelCooker::PAGE_SIZE * 10;
+
+    auto cooked = LevelCooker::index(LevelCooker::serialise(level, SOURCE), SOURCE);
+    ASSERT_TRUE(cooked.has_value());
+    EXPECT_EQ(cooked->getSpawn(), level.spawn);
+
+    const auto &pages = cooked->getPages();
+    ASSERT_EQ(pages.size(), 2);
+    EXPECT_EQ(pages.at(0).offset + pages.at(0).size, pages.at(1).offset);
+
+    // The far wall is on its own, everything else is together
+    auto far = cooked->readPage(pages.at(1));
+    ASSERT_EQ(far.walls.size(), 1);
+    EXPECT_EQ(far.walls.at(0).rect.y, level.walls.back().rect.y);
+    EXPECT_TRUE(far.decorations.empty());
+
+    auto all = cooked->readAll();
+    EXPECT_EQ(all.walls.size(), 3);
+    EXPECT_EQ(all.decorations.size(), 1);
+}
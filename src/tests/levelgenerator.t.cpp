@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include "level_generator.h"
+#include "level_reader.h"
+
+namespace {
+    LevelData readGenerated(const LevelGenerator &generator) {
+        auto svg = generator.generate();
+        return LevelReader::readBuffer(svg.data(), svg.size(), "generated");
+    }
+}
+
+TEST(LevelGenerator, MakesRequestedNumberOfElements) {
+    auto level = readGenerated(LevelGenerator().setElements(200));
+
+    auto total = level.walls.size() + level.deathZones.size() + level.checkpoints.size() + level.decorations.size();
+    EXPECT_EQ(total, 200);
+    EXPECT_EQ(level.deathZones.size(), 20);
+    EXPECT_EQ(level.checkpoints.size(), 10);
+    EXPECT_EQ(level.decorations.size(), 30);
+
+    ASSERT_FALSE(level.checkpoints.empty());
+    EXPECT_TRUE(level.checkpoints.back().finish);
+}
+
+TEST(LevelGenerator, SameSeedMakesSameLevel) {
+    auto generator = LevelGenerator().setElements(100).setSeed(7);
+
+    EXPECT_EQ(generator.generate(), generator.generate());
+    EXPECT_NE(generator.generate(), LevelGenerator().setElements(100).setSeed(8).generate());
+}
+
+TEST(LevelGenerator, PolygonsHaveRequestedComplexity) {
+    auto level = readGenerated(LevelGenerator().setElements(50).setPolygonShare(1).setPathComplexity(12));
+
+    for (const auto &wall : level.walls) {
+        ASSERT_EQ(wall.type, LevelShape::Type::POLYGON);
+
+        // The closing point may or may not be repeated
+        EXPECT_GE(wall.polygon.outline.size(), 12);
+        EXPECT_LE(wall.polygon.outline.size(), 13);
+    }
+}
+
+TEST(LevelGenerator, ConvexWithoutConcavity) {
+    auto level = readGenerated(LevelGenerator().setElements(50).setPolygonShare(1).setConcavity(0));
+
+    for (const auto &wall : level.walls) {
+        const auto &outline = wall.polygon.outline;
+        auto area = Triangulator::signedArea(outline);
+
+        // Every triangle of a convex polygon fan has the same winding as the whole polygon
+        for (std::size_t i = 1; i + 1 < outline.size(); i++) {
+            auto triangle = Triangulator::signedArea({ outline[0], outline[i], outline[i + 1] });
+            EXPECT_GE(triangle * area, -0.0001f);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <entt/entt.hpp>
+
+#include "level_pager.h"
+#include "map_maker.h"
+
+namespace {
+    LevelShape makeWall(float x, float y) {
+        LevelShape wall;
+        wall.rect = Dimensions { x, y, 4, 1 };
+
+        return wall;
+    }
+
+    std::size_t countBodies(entt::registry &registry) {
+        return registry.view<BodyPtr>().size();
+    }
+}
+
+TEST(LevelPager, OnlyKeepsNearbyPagesActive) {
+    entt::registry registry;
+    entt::dispatcher dispatcher;
+    Physics physics(registry, dispatcher);
+    MapShapeBuilder builder(registry, physics);
+    LevelPager pager(registry, physics, builder);
+
+    LevelData level;
+    level.walls.push_back(makeWall(0, 0));
+    level.walls.push_back(makeWall(2, 2));
+    level.walls.push_back(makeWall(0, LevelCooker::PAGE_SIZE * 10));
+    pager.load(level);
+
+    ASSERT_EQ(pager.pageCount(), 2);
+
+    pager.update(sf::Vector2f(0, 0));
+    EXPECT_EQ(pager.activePageCount(), 1);
+    EXPECT_EQ(countBodies(registry), 2);
+
+    // Moving to the far page loads it and drops the first
+    pager.update(sf::Vector2f(0, LevelCooker::PAGE_SIZE * 10));
+    EXPECT_EQ(pager.activePageCount(), 1);
+    EXPECT_EQ(countBodies(registry), 1);
+    EXPECT_EQ(physics.getWorld().GetBodyCount(), 1);
+}
+
+TEST(LevelPager, KeepsPagesBetweenActivateAndDeactivateDistance) {
+    entt::registry registry;
+    entt::dispatcher dispatcher;
+    Physics physics(registry, dispatcher);
+    MapShapeBuilder builder(registry, physics);
+    LevelPager pager(registry, physics, builder);
+
+    LevelData level;
+    level.walls.push_back(makeWall(0, 0));
+    pager.load(level);
+
+    pager.update(sf::Vector2f(0, 0));
+    EXPECT_EQ(pager.activePageCount(), 1);
+
+    // Past where it would be loaded but not far enough to be removed
+    auto between = (LevelPager::ACTIVATE_DISTANCE + LevelPager::DEACTIVATE_DISTANCE) / 2.f;
+    pager.update(sf::Vector2f(between, 0));
+    EXPECT_EQ(pager.activePageCount(), 1);
+
+    pager.update(sf::Vector2f(LevelPager::DEACTIVATE_DISTANCE * 2, 0));
+    EXPECT_EQ(pager.activePageCount(), 0);
+    EXPECT_EQ(countBodies(registry), 0);
+}
+
+TEST(LevelPager, CanLoadPagesInBackground) {
+    entt::registry registry;
+    entt::dispatcher dispatcher;
+    Physics physics(registry, dispatcher);
+    MapShapeBuilder builder(registry, physics);
+    LevelPager pager(registry, physics, builder);
+    ThreadPool pool(2);
+
+    LevelData level;
+    level.walls.push_back(makeWall(0, 0));
+    pager.load(level);
+
+    // The page is required where the focus is so has to be there straight away
+    pager.update(sf::Vector2f(0, 0), &pool);
+    EXPECT_EQ(pager.activePageCount(), 1);
+}
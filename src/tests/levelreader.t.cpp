@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+
+#include "level_reader.h"
+
+namespace {
+    float meshArea(const Mesh& mesh) {
+        float area = 0;
+
+        for (std::size_t i = 0; i < mesh.indices.size(); i += 3) {
+            const auto& a = mesh.vertices[mesh.indices[i]];
+            const auto& b = mesh.vertices[mesh.indices[i + 1]];
+            const auto& c = mesh.vertices[mesh.indices[i + 2]];
+            area += ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) / 2.f;
+        }
+
+        return std::abs(area);
+    }
+}
+
+TEST(LevelReader, KeepsSeparateSubPathsApart) {
+    const std::string svg = R"(
+<svg xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape">
+  <g inkscape:label="decorations">
+    <path d="M 0,0 h 10 v 10 h -10 z M 20,0 h 5 v 5 h -5 z" />
+  </g>
+  <g inkscape:label="objects">
+    <rect id="player" x="1" y="2" width="2" height="4" />
+  </g>
+</svg>
+)";
+
+    auto level = LevelReader::readBuffer(svg.data(), svg.size(), "test");
+
+    ASSERT_EQ(level.decorations.size(), 1);
+    EXPECT_FLOAT_EQ(meshArea(level.decorations.at(0).polygon.mesh), 125.f);
+
+    for (const auto &detail : level.decorations.at(0).polygon.detailLevels) {
+        EXPECT_FLOAT_EQ(meshArea(detail.mesh), 125.f);
+    }
+}
+
+TEST(LevelReader, CanAddLayerHandler) {
+    const std::string svg = R"(
+<svg xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape">
+  <g inkscape:label="unknown">
+    <rect x="0" y="0" width="1" height="1" />
+  </g>
+  <g inkscape:label="extra_walls">
+    <rect x="0" y="0" width="1" height="1" />
+    <rect x="2" y="0" width="1" height="1" />
+  </g>
+  <g inkscape:label="objects">
+    <rect id="player" x="1" y="2" width="2" height="4" />
+  </g>
+</svg>
+)";
+
+    int layers = 0;
+    LevelReader::ScopedLayerHandler handler("extra_walls", [&layers](const pugi::xml_node &layer, LevelReader::Context &context) {
+        layers++;
+
+        for (const auto &child : layer.children("rect")) {
+            LevelShape shape;
+            shape.rect = LevelReader::readDimensions(child);
+            context.level.walls.push_back(shape);
+        }
+    });
+
+    auto level = LevelReader::readBuffer(svg.data(), svg.size(), "test");
+
+    EXPECT_EQ(layers, 1);
+    ASSERT_EQ(level.walls.size(), 2);
+    EXPECT_EQ(level.walls.at(1).rect.x, 2.5f);
+}
+
+TEST(LevelReader, PutsBackReplacedLayerHandlers) {
+    const std::string svg = R"(
+<svg xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape">
+  <g inkscape:label="walls">
+    <rect x="0" y="0" width="1" height="1" />
+  </g>
+  <g inkscape:label="objects">
+    <rect id="player" x="1" y="2" width="2" height="4" />
+  </g>
+</svg>
+)";
+
+    {
+        LevelReader::ScopedLayerHandler handler("walls", [](const pugi::xml_node&, LevelReader::Context&) {});
+        EXPECT_TRUE(LevelReader::readBuffer(svg.data(), svg.size(), "test").walls.empty());
+    }
+
+    EXPECT_EQ(LevelReader::readBuffer(svg.data(), svg.size(), "test").walls.size(), 1);
+}
+
+TEST(LevelReader, ThrowsWithoutPlayer) {
+    const std::string svg = R"(<svg><g inkscape:label="walls"/></svg>)";
+
+    EXPECT_THROW(LevelReader::readBuffer(svg.data(), svg.size(), "test"), std::runtime_error);
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <spdlog/async_logger.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include "logging.h"
+
+TEST(Logging, SharesOneLoggerPerCategory) {
+    auto first = Logging::get("test category");
+    auto second = Logging::get("test category");
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first->name(), "test category");
+    EXPECT_NE(first, Logging::get("test other category"));
+}
+
+TEST(Logging, SetsLevelsPerCategory) {
+    auto quiet = Logging::get("test quiet");
+    auto loud = Logging::get("test loud");
+
+    Logging::setLevels("info,test quiet=warn");
+    EXPECT_EQ(quiet->level(), spdlog::level::warn);
+    EXPECT_EQ(loud->level(), spdlog::level::info);
+
+    // Categories made later still get the level they were configured with
+    Logging::setLevels("test later=error");
+    EXPECT_EQ(Logging::get("test later")->level(), spdlog::level::err);
+
+    Logging::setLevels("info");
+}
+
+TEST(Logging, LogsInTheBackgroundAfterInit) {
+    Logging::init(Logging::Overflow::DROP, spdlog::level::info, 16);
+
+    auto logger = Logging::get("test async");
+    EXPECT_NE(std::dynamic_pointer_cast<spdlog::async_logger>(logger), nullptr);
+    EXPECT_NE(std::dynamic_pointer_cast<spdlog::async_logger>(spdlog::default_logger()), nullptr);
+
+    SPDLOG_LOGGER_INFO(logger, "Logged from the game thread, written from the logging thread");
+    EXPECT_EQ(Logging::droppedMessages(), 0);
+
+    Logging::shutdown();
+
+    // Leave a synchronous default logger for the rest of the tests
+    spdlog::set_default_logger(std::make_shared<spdlog::logger>("", std::make_shared<spdlog::sinks::stdout_color_sink_mt>()));
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include "mesh_cache.h"
+#include "mesh_shape.h"
+
+TEST(MeshCache, SharesIdenticalGeometry) {
+    MeshCache cache;
+
+    sf::RectangleShape first(sf::Vector2f(2, 1));
+    first.setPosition(10, 10);
+    sf::RectangleShape second(sf::Vector2f(2, 1));
+    second.setPosition(-5, 3);
+
+    auto a = cache.createDrawable(first, 0);
+    auto b = cache.createDrawable(second, 1);
+
+    EXPECT_EQ(a.mesh, b.mesh);
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(b.position, sf::Vector2f(-5, 3));
+    EXPECT_EQ(b.zIndex, 1);
+}
+
+TEST(MeshCache, KeepsDifferentColoursApart) {
+    MeshCache cache;
+
+    sf::RectangleShape first(sf::Vector2f(2, 1));
+    sf::RectangleShape second(sf::Vector2f(2, 1));
+    second.setFillColor(sf::Color::Red);
+
+    EXPECT_NE(cache.add(first), cache.add(second));
+}
+
+TEST(MeshCache, UsesTriangulationOfMeshShapes) {
+    MeshCache cache;
+    std::vector<sf::Vector2f> outline {{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}};
+
+    MeshShape shape(outline, Triangulator::triangulate(outline));
+    const auto &mesh = cache.get(cache.add(shape));
+
+    EXPECT_EQ(mesh.indices.size(), 12);
+    EXPECT_EQ(mesh.bounds, sf::FloatRect(0, 0, 4, 4));
+}
+
+TEST(MeshCache, KeepsMeshesInPlaceAsItGrows) {
+    MeshCache cache;
+
+    sf::RectangleShape first(sf::Vector2f(1, 1));
+    const auto *mesh = &cache.get(cache.add(first));
+
+    // Enough to need more than one block of storage
+    for (int i = 2; i < 3000; i++) {
+        sf::RectangleShape shape(sf::Vector2f((float) i, 1));
+        cache.add(shape);
+    }
+
+    EXPECT_EQ(cache.size(), 2999);
+    EXPECT_EQ(&cache.get(0), mesh);
+    EXPECT_EQ(cache.get(2998).bounds, sf::FloatRect(0, 0, 2999, 1));
+    EXPECT_THROW((void) cache.get(2999), std::out_of_range);
+}
+
+TEST(MeshCache, KeepsMeshesWithDifferentDetailLevelsApart) {
+    MeshCache cache;
+    std::vector<sf::Vector2f> outline {{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}};
+
+    MeshShape plain(outline, Triangulator::triangulate(outline));
+    MeshShape detailed(outline, Triangulator::triangulate(outline));
+    detailed.addDetailLevel(2.f, Triangulator::triangulate(std::vector<sf::Vector2f> {{0, 0}, {4, 0}, {0, 4}}));
+
+    auto first = cache.add(plain);
+    auto second = cache.add(detailed);
+
+    // Adding the detailed shape leaves the mesh already handed out as it was
+    EXPECT_NE(first, second);
+    EXPECT_TRUE(cache.get(first).detailLevels.empty());
+    ASSERT_EQ(cache.get(second).detailLevels.size(), 1);
+    EXPECT_EQ(cache.get(second).detailLevels[0].tolerance, 2.f);
+}
+
+TEST(MeshCache, FreesReleasedMeshesOnceTheirFramesAreDrawn) {
+    MeshCache cache;
+    sf::RectangleShape shape(sf::Vector2f(2, 1));
+
+    auto frame = cache.nextFrame();
+    auto handle = cache.add(shape);
+    cache.release(handle);
+
+    // The frame being drawn was captured before the release, so it could still hold the mesh
+    cache.collect(frame);
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(cache.get(handle).indices.size(), 6);
+
+    cache.collect(cache.nextFrame());
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_TRUE(cache.get(handle).vertices.empty());
+
+    // The handle is handed out again once it is free
+    sf::RectangleShape other(sf::Vector2f(3, 1));
+    EXPECT_EQ(cache.add(other), handle);
+    EXPECT_EQ(cache.get(handle).bounds, sf::FloatRect(0, 0, 3, 1));
+}
+
+TEST(MeshCache, KeepsMeshesAddedAgainBeforeTheyAreFreed) {
+    MeshCache cache;
+    sf::RectangleShape shape(sf::Vector2f(2, 1));
+
+    auto handle = cache.add(shape);
+    cache.release(handle);
+    EXPECT_EQ(cache.add(shape), handle);
+
+    cache.nextFrame();
+    cache.collect(cache.nextFrame());
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(cache.get(handle).indices.size(), 6);
+
+    cache.release(handle);
+    EXPECT_THROW(cache.release(handle), std::runtime_error);
+}
+
+TEST(MeshCache, ReleasesDetailLevelsWithTheirMesh) {
+    MeshCache cache;
+    std::vector<sf::Vector2f> outline {{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}};
+
+    MeshShape shape(outline, Triangulator::triangulate(outline));
+    shape.addDetailLevel(2.f, Triangulator::triangulate(std::vector<sf::Vector2f> {{0, 0}, {4, 0}, {0, 4}}));
+
+    // Shared by two drawables, so both have to go before it is freed
+    auto handle = cache.add(shape);
+    EXPECT_EQ(cache.add(shape), handle);
+    EXPECT_EQ(cache.size(), 2);
+
+    cache.release(handle);
+    cache.collect(cache.nextFrame() + 1);
+    EXPECT_EQ(cache.size(), 2);
+
+    cache.release(handle);
+    cache.collect(cache.nextFrame() + 1);
+    EXPECT_EQ(cache.size(), 0);
+}
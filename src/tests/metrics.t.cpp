@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "metrics.h"
+
+TEST(Metrics, AggregatesSamplesOverTheInterval) {
+    Metrics metrics;
+
+    metrics.sample("step_ms", 2);
+    metrics.sample("step_ms", 6);
+    metrics.sample("step_ms", 1);
+
+    const auto *series = metrics.get("step_ms");
+    ASSERT_NE(series, nullptr);
+    EXPECT_EQ(series->count, 3);
+    EXPECT_DOUBLE_EQ(series->min, 1);
+    EXPECT_DOUBLE_EQ(series->max, 6);
+    EXPECT_DOUBLE_EQ(series->mean(), 3);
+    EXPECT_DOUBLE_EQ(series->last, 1);
+
+    metrics.reset();
+    metrics.sample("step_ms", 4);
+
+    EXPECT_EQ(series->count, 1);
+    EXPECT_DOUBLE_EQ(series->min, 4);
+    EXPECT_DOUBLE_EQ(series->max, 4);
+}
+
+TEST(Metrics, CountersKeepTheirTotals) {
+    Metrics metrics;
+
+    metrics.increment("respawns");
+    metrics.increment("respawns", 2);
+    metrics.reset();
+    metrics.increment("respawns");
+
+    const auto *series = metrics.get("respawns");
+    ASSERT_NE(series, nullptr);
+    EXPECT_DOUBLE_EQ(series->sum, 1);
+    EXPECT_DOUBLE_EQ(series->total, 4);
+    EXPECT_EQ(metrics.get("missing"), nullptr);
+
+    EXPECT_THROW(metrics.sample("respawns", 1), std::runtime_error);
+}
+
+TEST(MetricsExporter, WritesCsvRows) {
+    Metrics metrics;
+    metrics.increment("ropes_fired", 2);
+    metrics.sample("world_bodies", 10);
+    metrics.sample("world_bodies", 20);
+    metrics.sample("world_joints", 1);
+    metrics.reset();
+    metrics.sample("world_bodies", 30);
+
+    std::ostringstream out;
+    MetricsExporter::writeCsvHeader(out);
+    MetricsExporter::writeCsv(out, metrics, 12.5);
+
+    EXPECT_EQ(
+        out.str(),
+        "timestamp,metric,type,count,sum,min,mean,max,total\n"
+        "12.500,ropes_fired,counter,0,0.000,,,,2.000\n"
+        "12.500,world_bodies,gauge,1,30.000,30.000,30.000,30.000,\n"
+        "12.500,world_joints,gauge,0,,,,,\n"
+    );
+}
+
+TEST(MetricsExporter, WritesOpenMetrics) {
+    Metrics metrics;
+    metrics.increment("respawns", 3);
+    metrics.sample("box2d_step_ms", 1);
+    metrics.sample("box2d_step_ms", 3);
+    metrics.sample("unsampled", 1);
+    metrics.reset();
+    metrics.sample("box2d_step_ms", 1);
+    metrics.sample("box2d_step_ms", 3);
+
+    std::ostringstream out;
+    MetricsExporter::writeOpenMetrics(out, metrics);
+
+    EXPECT_EQ(
+        out.str(),
+        "# TYPE slinger_box2d_step_ms gauge\n"
+        "slinger_box2d_step_ms{stat=\"min\"} 1.000\n"
+        "slinger_box2d_step_ms{stat=\"mean\"} 2.000\n"
+        "slinger_box2d_step_ms{stat=\"max\"} 3.000\n"
+        "# TYPE slinger_respawns counter\n"
+        "slinger_respawns_total 3.000\n"
+        "# EOF\n"
+    );
+
+    EXPECT_EQ(MetricsExporter::formatFor("soak.csv"), MetricsExporter::Format::CSV);
+    EXPECT_EQ(MetricsExporter::formatFor("soak.prom"), MetricsExporter::Format::OPEN_METRICS);
+}
+
+TEST(Metrics, MakesMetricNamesFromZoneNames) {
+    EXPECT_EQ(Metrics::toMetricName("Physics::handlePhysics"), "physics_handlephysics");
+    EXPECT_EQ(Metrics::toMetricName("b2World::Step"), "b2world_step");
+    EXPECT_EQ(Metrics::toMetricName("::odd name!"), "odd_name");
+}
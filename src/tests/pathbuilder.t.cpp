@@ -1,52 +1,158 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "path_builder.h"
-#include "regexer.h"
 
-TEST(PathBuilder, CanBuildPath) {
-    Regexer regexer(PathBuilder::COMMAND_REGEX);
+TEST(PathBuilder, CanSplitSubPathsIntoContours) {
+    auto contours = PathBuilder::buildContours("M 0,0 H 10 V 10 H 0 Z m 2,2 h 2 v 2 h -2 z");
+    ASSERT_EQ(contours.size(), 2);
+
+    ASSERT_EQ(contours.at(0).size(), 5);
+    EXPECT_EQ(contours.at(0).at(2), sf::Vector2f(10, -10));
 
-    auto matches = regexer.search("M 72.732231,91.993675 H 85.979527 L 72.732231,118.39366 Z");
-    ASSERT_EQ(matches.size(), 4);
-    EXPECT_EQ("M 72.732231,91.993675 ", matches.at(0).matchedString());
+    ASSERT_EQ(contours.at(1).size(), 5);
+    EXPECT_EQ(contours.at(1).at(0), sf::Vector2f(2, -2));
+    EXPECT_EQ(contours.at(1).at(4), sf::Vector2f(2, -2));
+}
 
-    ASSERT_EQ(matches.at(0).groups().size(), 2);
-    EXPECT_EQ("M", matches.at(0).groups().at(0));
-    EXPECT_EQ("72.732231,91.993675 ", matches.at(0).groups().at(1));
+TEST(PathBuilder, CanBuildPointsFromPath) {
+    auto points = PathBuilder::build("M 72.732231,91.993675 H 85.979527 L 72.732231,118.39366 Z");
+    ASSERT_EQ(points.size(), 4);
 
-    EXPECT_TRUE(true);
+    EXPECT_EQ(points.at(0), sf::Vector2f(72.732231f, -91.993675f));
+    EXPECT_EQ(points.at(1), sf::Vector2f(85.979527f, -91.993675f));
+    EXPECT_EQ(points.at(2), sf::Vector2f(72.732231f, -118.39366f));
+    EXPECT_EQ(points.at(3), points.at(0));
 }
 
 TEST(PathBuilder, CanParseExponentInCommand) {
-    Regexer regexer(PathBuilder::COMMAND_REGEX);
+    auto points = PathBuilder::build("M 72.732231e10,91.993675 H 85.979527 L 72.732231,118.39366 Z");
+    ASSERT_EQ(points.size(), 4);
 
-    auto matches = regexer.search("M 72.732231e10,91.993675 H 85.979527 L 72.732231,118.39366 Z");
-    ASSERT_EQ(matches.size(), 4);
-    EXPECT_EQ("M 72.732231e10,91.993675 ", matches.at(0).matchedString());
-
-    ASSERT_EQ(matches.at(0).groups().size(), 2);
-    EXPECT_EQ("M", matches.at(0).groups().at(0));
-    EXPECT_EQ("72.732231e10,91.993675 ", matches.at(0).groups().at(1));
+    EXPECT_EQ(points.at(0), sf::Vector2f(72.732231e10f, -91.993675f));
+    EXPECT_EQ(points.at(1), sf::Vector2f(85.979527f, -91.993675f));
+    EXPECT_EQ(points.at(3), points.at(0));
 }
 
 TEST(PathBuilder, CanParseNumber) {
-    Regexer regexer(PathBuilder::COORDINATE_REGEX);
+    auto points = PathBuilder::build("M 72.732231,91.993675 85.979527,118.39366");
+    ASSERT_EQ(points.size(), 2);
 
-    auto matches = regexer.search("72.732231,91.993675 85.979527,118.39366");
-    ASSERT_EQ(matches.size(), 4);
-    EXPECT_EQ("72.732231", matches.at(0).matchedString());
-    EXPECT_EQ("91.993675", matches.at(1).matchedString());
-    EXPECT_EQ("85.979527", matches.at(2).matchedString());
-    EXPECT_EQ("118.39366", matches.at(3).matchedString());
+    EXPECT_EQ(points.at(0), sf::Vector2f(72.732231f, -91.993675f));
+    EXPECT_EQ(points.at(1), sf::Vector2f(85.979527f, -118.39366f));
 }
 
 TEST(PathBuilder, CanParseNumberWithExponent) {
-    Regexer regexer(PathBuilder::COORDINATE_REGEX);
-
-    auto matches = regexer.search("72.732231e10,91.993675 85.979527e-8,118.39366");
-    ASSERT_EQ(matches.size(), 4);
-    EXPECT_EQ("72.732231e10", matches.at(0).matchedString());
-    EXPECT_EQ("91.993675", matches.at(1).matchedString());
-    EXPECT_EQ("85.979527e-8", matches.at(2).matchedString());
-    EXPECT_EQ("118.39366", matches.at(3).matchedString());
-}
\ No newline at end of file
+    auto points = PathBuilder::build("M 72.732231e10,91.993675 85.979527e-8,118.39366");
+    ASSERT_EQ(points.size(), 2);
+
+    EXPECT_EQ(points.at(0), sf::Vector2f(72.732231e10f, -91.993675f));
+    EXPECT_EQ(points.at(1), sf::Vector2f(85.979527e-8f, -118.39366f));
+}
+
+TEST(PathBuilder, CanBuildCompactPath) {
+    auto points = PathBuilder::build("m1,1l2-1,.5.5e1H+3v-2z");
+    ASSERT_EQ(points.size(), 6);
+
+    EXPECT_EQ(points.at(0), sf::Vector2f(1, -1));
+    EXPECT_EQ(points.at(1), sf::Vector2f(3, 0));
+    EXPECT_EQ(points.at(2), sf::Vector2f(3.5f, -5));
+    EXPECT_EQ(points.at(3), sf::Vector2f(3, -5));
+    EXPECT_EQ(points.at(4), sf::Vector2f(3, -3));
+    EXPECT_EQ(points.at(5), sf::Vector2f(1, -1));
+}
+
+TEST(PathBuilder, CanRepeatMoveAsLine) {
+    auto points = PathBuilder::build("M 0,0 10,0 10,10");
+    ASSERT_EQ(points.size(), 3);
+    EXPECT_EQ(points.at(2), sf::Vector2f(10, -10));
+}
+
+TEST(PathBuilder, CanAppendToBuffer) {
+    PointList points { sf::Vector2f(5, 5) };
+    std::vector<std::size_t> starts;
+
+    PathBuilder::build("m 1,1 h 1", points, &starts);
+    ASSERT_EQ(points.size(), 3);
+    EXPECT_EQ(points.at(1), sf::Vector2f(1, -1));
+
+    ASSERT_EQ(starts.size(), 1);
+    EXPECT_EQ(starts.at(0), 1);
+}
+
+TEST(PathBuilder, ThrowsOnBadPath) {
+    EXPECT_THROW(PathBuilder::build("M 0,0 L 1"), std::runtime_error);
+    EXPECT_THROW(PathBuilder::build("0,0 L 1,1"), std::runtime_error);
+    EXPECT_THROW(PathBuilder::build("M 0,0 X 1,1"), std::runtime_error);
+}
+
+TEST(PathBuilder, CanFlattenCubicWithinTolerance) {
+    auto points = PathBuilder::build("M 0,0 C 0,10 10,10 10,0", 0.01f);
+    ASSERT_GT(points.size(), 4);
+    EXPECT_EQ(points.front(), sf::Vector2f(0, 0));
+    EXPECT_EQ(points.back(), sf::Vector2f(10, 0));
+
+    // The peak of this curve is at 7.5
+    float lowest = 0;
+    for (const auto &point : points) {
+        lowest = std::min(lowest, point.y);
+    }
+    EXPECT_NEAR(lowest, -7.5f, 0.01f);
+}
+
+TEST(PathBuilder, UsesFewerPointsForLooserTolerance) {
+    auto fine = PathBuilder::build("M 0,0 C 0,10 10,10 10,0", 0.001f);
+    auto coarse = PathBuilder::build("M 0,0 C 0,10 10,10 10,0", 0.5f);
+
+    EXPECT_LT(coarse.size(), fine.size());
+
+    // Straight curves don't need splitting at all
+    auto straight = PathBuilder::build("M 0,0 C 1,0 2,0 3,0", 0.001f);
+    EXPECT_EQ(straight.size(), 2);
+}
+
+TEST(PathBuilder, CanRepeatAndReflectCurves) {
+    auto repeated = PathBuilder::build("M 0,0 c 0,1 1,1 1,0 0,1 1,1 1,0", 0.5f);
+    EXPECT_EQ(repeated.back(), sf::Vector2f(2, 0));
+
+    auto smooth = PathBuilder::build("M 0,0 C 0,10 10,10 10,0 S 20,-10 20,0", 0.01f);
+    EXPECT_EQ(smooth.back(), sf::Vector2f(20, 0));
+
+    // The reflected control point sends the second half below the start
+    float highest = 0;
+    for (const auto &point : smooth) {
+        highest = std::max(highest, point.y);
+    }
+    EXPECT_NEAR(highest, 7.5f, 0.01f);
+}
+
+TEST(PathBuilder, CanFlattenQuadratics) {
+    auto points = PathBuilder::build("M 0,0 Q 5,10 10,0 T 20,0", 0.01f);
+    EXPECT_EQ(points.back(), sf::Vector2f(20, 0));
+
+    float lowest = 0, highest = 0;
+    for (const auto &point : points) {
+        lowest = std::min(lowest, point.y);
+        highest = std::max(highest, point.y);
+    }
+    EXPECT_NEAR(lowest, -5, 0.01f);
+    EXPECT_NEAR(highest, 5, 0.01f);
+}
+
+TEST(PathBuilder, CanFlattenArcs) {
+    auto points = PathBuilder::build("M 0,0 A 5,5 0 0 1 10,0", 0.01f);
+    ASSERT_GT(points.size(), 3);
+    EXPECT_EQ(points.back(), sf::Vector2f(10, 0));
+
+    // Sweeping clockwise in svg space goes over the top, which is up once flipped
+    for (const auto &point : points) {
+        auto offset = point - sf::Vector2f(5, 0);
+        EXPECT_NEAR(std::sqrt(offset.x * offset.x + offset.y * offset.y), 5, 0.001f);
+        EXPECT_GE(point.y, -0.001f);
+    }
+
+    // Flags don't need separating
+    auto compact = PathBuilder::build("M0,0a5,5 0 0110,0", 0.01f);
+    EXPECT_EQ(compact.size(), points.size());
+}
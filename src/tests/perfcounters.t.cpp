@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include "perf_counters.h"
+
+namespace {
+    // Something for the counters to count that the compiler can't take away
+    std::uint64_t work() {
+        volatile std::uint64_t total = 0;
+        for (std::uint64_t i = 0; i < 100000; i++) {
+            total = total + i * i;
+        }
+
+        return total;
+    }
+}
+
+TEST(PerfCounters, SaysWhyWhenUnavailable) {
+    PerfCounters counters;
+
+    if (counters.isAvailable()) {
+        EXPECT_TRUE(counters.getError().empty());
+        EXPECT_TRUE(counters.isCounting(PerfCounters::Event::CYCLES));
+    } else {
+        EXPECT_FALSE(counters.getError().empty());
+
+        work();
+        for (auto count : counters.lap()) {
+            EXPECT_EQ(count, 0);
+        }
+    }
+}
+
+TEST(PerfCounters, LapsCountOnlyTheWorkSinceTheLastLap) {
+    PerfCounters counters;
+    if (!counters.isAvailable()) {
+        GTEST_SKIP() << counters.getError();
+    }
+
+    counters.lap();
+    work();
+    auto lap = counters.lap();
+    auto total = counters.read();
+
+    EXPECT_GT(lap[(std::size_t) PerfCounters::Event::CYCLES], 0);
+    EXPECT_LE(lap[(std::size_t) PerfCounters::Event::CYCLES], total[(std::size_t) PerfCounters::Event::CYCLES]);
+
+    if (counters.isCounting(PerfCounters::Event::INSTRUCTIONS)) {
+        // Every iteration takes a few instructions
+        EXPECT_GT(lap[(std::size_t) PerfCounters::Event::INSTRUCTIONS], 100000);
+    }
+}
@@ -15,4 +15,31 @@ TEST(Regexer, CanGetMatches) {
     EXPECT_EQ("72.732231,91.993675 ", matches.at(0).groups().at(1));
 
     EXPECT_TRUE(true);
-}
\ No newline at end of file
+}
+
+TEST(Regexer, CanIterateMatchesWithoutCopying) {
+    Regexer regexer(R"(\s?([a-zA-Z])\s([^a-zA-Z]+\s))");
+    std::string path = "M 72.732231,91.993675 H 85.979527 L 72.732231,118.39366 Z";
+
+    std::vector<std::string_view> commands;
+    for (const auto &match : regexer.matches(path)) {
+        ASSERT_EQ(match.groupCount(), 2);
+        commands.push_back(match.group(0));
+
+        // Views point back into the searched string
+        EXPECT_GE(match.matchedString().data(), path.data());
+        EXPECT_LT(match.matchedString().data(), path.data() + path.size());
+    }
+
+    ASSERT_EQ(commands.size(), 3);
+    EXPECT_EQ("M", commands.at(0));
+    EXPECT_EQ("H", commands.at(1));
+    EXPECT_EQ("L", commands.at(2));
+}
+
+TEST(Regexer, CanIterateEmptyString) {
+    Regexer regexer(R"(([a-z]))");
+
+    auto matches = regexer.matches("");
+    EXPECT_EQ(matches.begin(), matches.end());
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <SFML/Graphics/RectangleShape.hpp>
+
+#include "mesh_cache.h"
+#include "render_commands.h"
+
+namespace {
+    std::vector<Drawable> makeDrawables(MeshCache& meshes, const std::vector<const sf::Texture*>& textures, int count) {
+        std::vector<Drawable> drawables;
+
+        for (int i = 0; i < count; i++) {
+            sf::RectangleShape shape(sf::Vector2f(1.f + (float) (i % 7), 2.f));
+            shape.setPosition((float) i, (float) -i);
+            shape.setRotation((float) (i * 13 % 360));
+
+            auto drawable = meshes.createDrawable(shape, 0);
+            drawable.texture = textures[(std::size_t) i * textures.size() / count];
+            drawable.textureRect = sf::IntRect(i, 0, 16, 16);
+            drawables.push_back(drawable);
+        }
+
+        return drawables;
+    }
+}
+
+TEST(RenderCommandBuffer, StartsACommandWhenTheTextureChanges) {
+    MeshCache meshes;
+    sf::Texture first;
+    sf::Texture second;
+    auto drawables = makeDrawables(meshes, { &first, &second, &first }, 9);
+
+    RenderCommandBuffer commands;
+    for (const auto &drawable : drawables) {
+        commands.add(drawable, meshes.get(drawable.mesh));
+    }
+    commands.build();
+
+    // Two triangles for each rectangle
+    ASSERT_EQ(commands.getCommands().size(), 3);
+    EXPECT_EQ(commands.getCommands()[0].texture, &first);
+    EXPECT_EQ(commands.getCommands()[1].texture, &second);
+    EXPECT_EQ(commands.getCommands()[1].first, 18);
+    EXPECT_EQ(commands.getCommands()[2].count, 18);
+    EXPECT_EQ(commands.getVertexCount(), 54);
+}
+
+TEST(RenderCommandBuffer, BuildsTheSameVerticesAcrossThreads) {
+    MeshCache meshes;
+    sf::Texture first;
+    sf::Texture second;
+    auto drawables = makeDrawables(meshes, { &first, &second }, 1000);
+
+    RenderCommandBuffer serial;
+    RenderCommandBuffer parallel;
+    ThreadPool pool(4);
+
+    for (const auto &drawable : drawables) {
+        serial.add(drawable, meshes.get(drawable.mesh));
+        parallel.add(drawable, meshes.get(drawable.mesh));
+    }
+
+    serial.build();
+    parallel.build(&pool);
+
+    ASSERT_EQ(serial.getVertexCount(), parallel.getVertexCount());
+    for (std::size_t i = 0; i < serial.getVertexCount(); i++) {
+        const auto &expected = serial.getVertices()[i];
+        const auto &actual = parallel.getVertices()[i];
+
+        ASSERT_EQ(expected.position, actual.position) << "vertex " << i;
+        ASSERT_EQ(expected.color, actual.color) << "vertex " << i;
+        ASSERT_EQ(expected.texCoords, actual.texCoords) << "vertex " << i;
+    }
+}
+
+TEST(RenderCommandBuffer, KeepsItsMemoryBetweenFrames) {
+    MeshCache meshes;
+    sf::Texture texture;
+    auto drawables = makeDrawables(meshes, { &texture }, 300);
+
+    RenderCommandBuffer commands;
+    for (const auto &drawable : drawables) {
+        commands.add(drawable, meshes.get(drawable.mesh));
+    }
+    commands.build();
+    const auto *vertices = commands.getVertices();
+
+    commands.clear();
+    commands.add(drawables[0], meshes.get(drawables[0].mesh));
+    commands.build();
+
+    EXPECT_EQ(commands.getVertices(), vertices);
+    EXPECT_EQ(commands.getVertexCount(), 6);
+    ASSERT_EQ(commands.getCommands().size(), 1);
+    EXPECT_EQ(commands.getCommands()[0].count, 6);
+}
@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+
+#include "simplifier.h"
+
+TEST(Simplifier, RemovesCollinearPoints) {
+    auto points = Simplifier::simplify({{0, 0}, {1, 0}, {2, 0}, {3, 0}, {3, 3}, {0, 3}, {0, 0}}, 0.01f);
+
+    ASSERT_EQ(points.size(), 5);
+    EXPECT_EQ(points.at(0), sf::Vector2f(0, 0));
+    EXPECT_EQ(points.at(1), sf::Vector2f(3, 0));
+    EXPECT_EQ(points.back(), sf::Vector2f(0, 0));
+}
+
+TEST(Simplifier, RemovesDetailWithinTolerance) {
+    auto points = Simplifier::simplify({{0, 0}, {1, 0.05f}, {2, -0.05f}, {3, 0}, {3, 3}, {0, 3}, {0, 0}}, 0.1f);
+    EXPECT_EQ(points.size(), 5);
+
+    points = Simplifier::simplify({{0, 0}, {1, 0.5f}, {2, 0.27f}, {3, 0}, {3, 3}, {0, 3}, {0, 0}}, 0.1f);
+    EXPECT_EQ(points.size(), 6);
+}
+
+TEST(Simplifier, KeepsTinyPolygons) {
+    std::vector<sf::Vector2f> triangle {{0, 0}, {0.01f, 0}, {0, 0.01f}, {0, 0}};
+
+    EXPECT_EQ(Simplifier::simplify(triangle, 1.f).size(), 4);
+    EXPECT_EQ(Simplifier::simplify(triangle, 0.f).size(), 4);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "thread_pool.h"
+
+TEST(ThreadPool, CanSubmitTasks) {
+    ThreadPool pool(2);
+
+    auto first = pool.submit([]() { return 1; });
+    auto second = pool.submit([]() { return 2; });
+
+    EXPECT_EQ(first.get() + second.get(), 3);
+}
+
+TEST(ThreadPool, RethrowsFromFuture) {
+    ThreadPool pool(1);
+
+    auto future = pool.submit([]() -> int { throw std::runtime_error("failed"); });
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(ThreadPool, RunsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> counts(1000);
+
+    pool.parallelFor(counts.size(), [&counts](std::size_t i) { counts[i]++; });
+
+    for (const auto &count : counts) {
+        EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(ThreadPool, CanNestParallelFor) {
+    ThreadPool pool(2);
+    std::atomic<int> total = 0;
+
+    pool.parallelFor(4, [&pool, &total](std::size_t) {
+        pool.parallelFor(4, [&total](std::size_t) { total++; });
+    });
+
+    EXPECT_EQ(total, 16);
+}
+
+TEST(ThreadPool, RethrowsFromParallelFor) {
+    ThreadPool pool(2);
+
+    auto body = [](std::size_t i) {
+        if (i == 5) {
+            throw std::runtime_error("failed");
+        }
+    };
+
+    EXPECT_THROW(pool.parallelFor(10, body), std::runtime_error);
+}
+
+TEST(ThreadPool, WaitsForEveryJobOnACounter) {
+    ThreadPool pool(4);
+    JobCounter counter;
+    std::atomic<int> total = 0;
+
+    for (int i = 0; i < 100; i++) {
+        pool.run(counter, [&total]() { total++; });
+    }
+
+    pool.wait(counter);
+
+    EXPECT_TRUE(counter.isDone());
+    EXPECT_EQ(total, 100);
+}
+
+TEST(ThreadPool, RethrowsFromWait) {
+    ThreadPool pool(2);
+    JobCounter counter;
+
+    pool.run(counter, []() { throw std::runtime_error("failed"); });
+    pool.run(counter, []() {});
+
+    EXPECT_THROW(pool.wait(counter), std::runtime_error);
+    EXPECT_TRUE(counter.isDone());
+}
+
+TEST(ThreadPool, JobsCanWaitOnJobsOfTheirOwn) {
+    ThreadPool pool(2);
+    JobCounter outer;
+    std::atomic<int> total = 0;
+
+    // More waiting jobs than workers, which only finishes if waiting workers keep working
+    for (int i = 0; i < 4; i++) {
+        pool.run(outer, [&pool, &total]() {
+            JobCounter inner;
+            for (int j = 0; j < 8; j++) {
+                pool.run(inner, [&total]() { total++; });
+            }
+
+            pool.wait(inner);
+        });
+    }
+
+    pool.wait(outer);
+
+    EXPECT_EQ(total, 32);
+}
+
+TEST(ThreadPool, IdleWorkersStealQueuedWork) {
+    ThreadPool pool(4);
+    JobCounter counter;
+
+    // Everything is queued on one worker, the others can only help by stealing
+    pool.run(counter, [&pool]() {
+        JobCounter children;
+        for (int i = 0; i < 64; i++) {
+            pool.run(children, []() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+        }
+
+        pool.wait(children);
+    });
+
+    pool.wait(counter);
+    auto stats = pool.getStats();
+
+    EXPECT_GT(stats.stolen, 0);
+    EXPECT_EQ(stats.executed, 65);
+    EXPECT_EQ(stats.queued, 0);
+}
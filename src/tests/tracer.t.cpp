@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+#include "tracer.h"
+
+namespace {
+    std::string dumpTrace() {
+        std::ostringstream out;
+        Tracer::dump(out);
+
+        return out.str();
+    }
+
+    std::size_t count(const std::string &haystack, const std::string &needle) {
+        std::size_t found = 0;
+        for (auto pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) {
+            found++;
+        }
+
+        return found;
+    }
+}
+
+TEST(Tracer, OnlyRecordsWhileEnabled) {
+    Tracer::clear();
+
+    Tracer::setEnabled(false);
+    {
+        TraceZone zone("disabled zone");
+    }
+
+    Tracer::setEnabled(true);
+    {
+        TraceZone zone("enabled zone");
+    }
+    Tracer::setEnabled(false);
+
+    auto trace = dumpTrace();
+    EXPECT_EQ(count(trace, "disabled zone"), 0);
+    EXPECT_EQ(count(trace, "enabled zone"), 1);
+}
+
+TEST(Tracer, ClearForgetsRecordedZones) {
+    Tracer::setEnabled(true);
+    {
+        TraceZone zone("cleared zone");
+    }
+    Tracer::setEnabled(false);
+
+    Tracer::clear();
+    EXPECT_EQ(count(dumpTrace(), "cleared zone"), 0);
+}
+
+TEST(Tracer, RecordsEachThreadSeparately) {
+    Tracer::clear();
+    Tracer::setEnabled(true);
+
+    std::thread worker([]() {
+        Tracer::setThreadName("traced worker");
+        TraceZone zone("worker zone");
+    });
+    worker.join();
+
+    {
+        TraceZone zone("main zone");
+    }
+    Tracer::setEnabled(false);
+
+    auto trace = dumpTrace();
+    EXPECT_EQ(count(trace, "\"traced worker\""), 1);
+
+    // Zones from the two threads have different thread ids
+    auto workerZone = trace.find("worker zone");
+    auto mainZone = trace.find("main zone");
+    ASSERT_NE(workerZone, std::string::npos);
+    ASSERT_NE(mainZone, std::string::npos);
+
+    auto tid = [&trace](std::size_t from) {
+        auto start = trace.find("\"tid\":", from) + 6;
+        return trace.substr(start, trace.find(',', start) - start);
+    };
+    EXPECT_NE(tid(workerZone), tid(mainZone));
+}
+
+TEST(Tracer, KeepsTheLatestZonesWhenFull) {
+    Tracer::clear();
+    Tracer::setEnabled(true);
+
+    for (std::size_t i = 0; i < Tracer::EVENTS_PER_THREAD + 10; i++) {
+        TraceZone zone(i == 0 ? "first zone" : "later zone");
+    }
+    {
+        TraceZone zone("last zone");
+    }
+    Tracer::setEnabled(false);
+
+    auto trace = dumpTrace();
+    EXPECT_EQ(count(trace, "first zone"), 0);
+    EXPECT_EQ(count(trace, "last zone"), 1);
+    EXPECT_LE(count(trace, "later zone"), Tracer::EVENTS_PER_THREAD);
+}
+
+TEST(Tracer, ReusesTheBuffersOfFinishedThreads) {
+    Tracer::clear();
+    Tracer::setEnabled(true);
+
+    for (int i = 0; i < 8; i++) {
+        std::thread([]() {
+            Tracer::setThreadName("short lived");
+            TraceZone zone("short lived zone");
+        }).join();
+    }
+    Tracer::setEnabled(false);
+
+    // Each thread took over the last one's buffer, along with its name
+    auto trace = dumpTrace();
+    EXPECT_EQ(count(trace, "\"short lived\""), 1);
+    EXPECT_EQ(count(trace, "short lived zone"), 1);
+}
+
+TEST(Tracer, DumpsWhileAnotherThreadRecords) {
+    Tracer::clear();
+    Tracer::setEnabled(true);
+
+    std::atomic<bool> stop = false;
+    std::thread writer([&stop]() {
+        while (!stop) {
+            TraceZone zone("busy zone");
+        }
+    });
+
+    for (int i = 0; i < 5; i++) {
+        auto trace = dumpTrace();
+
+        // Lapped zones are dropped rather than written out torn
+        EXPECT_LE(count(trace, "busy zone"), Tracer::EVENTS_PER_THREAD);
+        EXPECT_EQ(count(trace, "busy zone"), count(trace, "\"ph\":\"X\""));
+    }
+
+    stop = true;
+    writer.join();
+    Tracer::setEnabled(false);
+}
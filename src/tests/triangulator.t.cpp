@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "triangulator.h"
+
+namespace {
+    float meshArea(const Mesh& mesh) {
+        float area = 0;
+
+        for (std::size_t i = 0; i < mesh.indices.size(); i += 3) {
+            const auto& a = mesh.vertices[mesh.indices[i]];
+            const auto& b = mesh.vertices[mesh.indices[i + 1]];
+            const auto& c = mesh.vertices[mesh.indices[i + 2]];
+            area += ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) / 2.f;
+        }
+
+        return area;
+    }
+}
+
+TEST(Triangulator, CanTriangulateClosedSquare) {
+    auto mesh = Triangulator::triangulate({{0, 0}, {0, 10}, {10, 10}, {10, 0}, {0, 0}});
+
+    ASSERT_EQ(mesh.vertices.size(), 4);
+    ASSERT_EQ(mesh.indices.size(), 6);
+    EXPECT_FLOAT_EQ(meshArea(mesh), 100.f);
+}
+
+TEST(Triangulator, CanTriangulateConcavePolygon) {
+    auto mesh = Triangulator::triangulate({{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}});
+
+    ASSERT_EQ(mesh.indices.size(), 12);
+    EXPECT_FLOAT_EQ(meshArea(mesh), 7.f);
+}
+
+TEST(Triangulator, CanTriangulatePolygonWithHoles) {
+    Triangulator::Contour outline {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    Triangulator::Contour hole {{3, 3}, {7, 3}, {7, 7}, {3, 7}};
+    Triangulator::Contour smallHole {{1, 1}, {2, 1}, {2, 2}, {1, 2}};
+
+    auto mesh = Triangulator::triangulate(std::vector<Triangulator::Contour> {hole, outline, smallHole});
+
+    EXPECT_FLOAT_EQ(meshArea(mesh), 83.f);
+}
+
+TEST(Triangulator, IgnoresDegeneratePolygons) {
+    auto mesh = Triangulator::triangulate({{0, 0}, {1, 1}, {0, 0}});
+
+    EXPECT_TRUE(mesh.indices.empty());
+}
+
+TEST(Triangulator, KeepsSeparateContoursApart) {
+    Triangulator::Contour first {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    Triangulator::Contour second {{20, 0}, {25, 0}, {25, 5}, {20, 5}};
+
+    auto mesh = Triangulator::triangulate(std::vector<Triangulator::Contour> {first, second});
+
+    EXPECT_FLOAT_EQ(meshArea(mesh), 125.f);
+}
+
+TEST(Triangulator, FillsIslandsInsideHoles) {
+    Triangulator::Contour outline {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    Triangulator::Contour hole {{2, 2}, {8, 2}, {8, 8}, {2, 8}};
+    Triangulator::Contour island {{4, 4}, {6, 4}, {6, 6}, {4, 6}};
+
+    auto mesh = Triangulator::triangulate(std::vector<Triangulator::Contour> {outline, hole, island});
+
+    EXPECT_FLOAT_EQ(meshArea(mesh), 68.f);
+}
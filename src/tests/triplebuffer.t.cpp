@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "triple_buffer.h"
+
+TEST(TripleBuffer, ReadsTheLatestPublishedValue) {
+    TripleBuffer<int> buffer;
+
+    EXPECT_FALSE(buffer.update());
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.front(), 2);
+
+    // Nothing new, so the reader keeps what it has
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.front(), 2);
+}
+
+TEST(TripleBuffer, WriterNeverTouchesTheFrontBuffer) {
+    TripleBuffer<int> buffer;
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.update();
+
+    for (int i = 2; i < 10; i++) {
+        EXPECT_NE(&buffer.back(), &buffer.front());
+        buffer.back() = i;
+        buffer.publish();
+    }
+
+    EXPECT_EQ(buffer.front(), 1);
+}
+
+TEST(TripleBuffer, HandsValuesToAnotherThreadInOrder) {
+    const int count = 100000;
+    TripleBuffer<std::pair<int, int>> buffer;
+    bool ordered = true;
+    bool consistent = true;
+
+    std::thread reader([&]() {
+        int last = 0;
+
+        while (last < count) {
+            buffer.wait();
+            buffer.update();
+
+            const auto &[first, second] = buffer.front();
+            ordered = ordered && first > last;
+            consistent = consistent && first == second;
+            last = first;
+        }
+    });
+
+    for (int i = 1; i <= count; i++) {
+        buffer.back() = { i, i };
+        buffer.publish();
+    }
+
+    reader.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(consistent);
+}
@@ -0,0 +1,108 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "level_analyzer.h"
+
+namespace {
+    const std::string USAGE =
+        "usage: slinger-analyze [--json] [--budgets file.json] [--budget metric=limit]... [level.svg]...";
+}
+
+/**
+ * Measures every level given on the command line, or every level in data/levels if none are
+ * given, and checks them against budgets. Exits with an error if any level is over budget.
+ */
+int main(int argc, char *argv[]) {
+    spdlog::set_pattern("[%l] %v");
+
+    std::vector<std::string> levels;
+    LevelAnalyzer::Budgets budgets;
+    bool json = false;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            if (arg == "--json") {
+                json = true;
+            } else if (arg == "--budgets" && i + 1 < argc) {
+                for (const auto &[name, limit] : LevelAnalyzer::readBudgets(argv[++i])) {
+                    budgets[name] = limit;
+                }
+            } else if (arg == "--budget" && i + 1 < argc) {
+                std::string budget = argv[++i];
+                auto split = budget.find('=');
+
+                if (split == std::string::npos) {
+                    throw std::runtime_error("Budgets are given as metric=limit, not " + budget);
+                }
+
+                budgets[budget.substr(0, split)] = std::stod(budget.substr(split + 1));
+            } else if (arg.rfind("--", 0) == 0) {
+                std::cerr << USAGE << std::endl;
+                return 2;
+            } else {
+                levels.push_back(arg);
+            }
+        }
+    } catch (const std::exception& error) {
+        SPDLOG_ERROR("{}", error.what());
+        std::cerr << USAGE << std::endl;
+        return 2;
+    }
+
+    if (levels.empty()) {
+        for (const auto &entry : std::filesystem::directory_iterator("data/levels")) {
+            if (entry.path().extension() == ".svg") {
+                levels.push_back(entry.path().string());
+            }
+        }
+    }
+
+    nlohmann::json reports = nlohmann::json::array();
+    int failures = 0;
+
+    for (const auto &level : levels) {
+        LevelReport report;
+
+        try {
+            report = LevelAnalyzer::analyze(level);
+        } catch (const std::runtime_error& error) {
+            SPDLOG_ERROR("Could not analyze {}: {}", level, error.what());
+            failures++;
+            continue;
+        }
+
+        auto overBudget = LevelAnalyzer::checkBudgets(report, budgets);
+        failures += overBudget.empty() ? 0 : 1;
+
+        if (json) {
+            auto entry = report.toJson();
+            entry["over_budget"] = overBudget;
+            reports.push_back(entry);
+            continue;
+        }
+
+        std::cout << report.name << std::endl;
+        for (const auto &[name, value] : report.metrics()) {
+            std::cout << "  " << std::left << std::setw(40) << name << value << std::endl;
+        }
+
+        for (const auto &message : overBudget) {
+            SPDLOG_ERROR("{}: {}", level, message);
+        }
+    }
+
+    if (json) {
+        std::cout << std::setw(4) << reports << std::endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
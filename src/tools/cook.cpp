@@ -0,0 +1,45 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "level_cooker.h"
+#include "thread_pool.h"
+
+/**
+ * Cooks every level given on the command line, or every level in data/levels if none are given.
+ * Levels whose cooked copy is already up to date are skipped.
+ */
+int main(int argc, char *argv[]) {
+    spdlog::set_pattern("[%l] %v");
+
+    std::vector<std::string> levels(argv + 1, argv + argc);
+
+    if (levels.empty()) {
+        for (const auto &entry : std::filesystem::directory_iterator("data/levels")) {
+            if (entry.path().extension() == ".svg") {
+                levels.push_back(entry.path().string());
+            }
+        }
+    }
+
+    ThreadPool pool;
+    int failures = 0;
+    for (const auto &level : levels) {
+        try {
+            if (LevelCooker::cook(level, &pool)) {
+                SPDLOG_INFO("Cooked {}", level);
+            } else {
+                SPDLOG_INFO("{} is up to date", level);
+            }
+        } catch (const std::runtime_error& error) {
+            SPDLOG_ERROR("Could not cook {}: {}", level, error.what());
+            failures++;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
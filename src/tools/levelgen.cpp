@@ -0,0 +1,69 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+
+#include <iostream>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "level_generator.h"
+
+namespace {
+    const std::string USAGE =
+        "usage: slinger-levelgen [--elements n] [--complexity points] [--concavity 0-1] "
+        "[--density 0-1] [--polygons 0-1] [--seed n] output.svg";
+}
+
+/**
+ * Writes a synthetic level for benchmarks and soak tests
+ */
+int main(int argc, char *argv[]) {
+    spdlog::set_pattern("[%l] %v");
+
+    LevelGenerator generator;
+    std::string output;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--elements" && hasValue) {
+                generator.setElements(std::stoul(argv[++i]));
+            } else if (arg == "--complexity" && hasValue) {
+                generator.setPathComplexity(std::stoul(argv[++i]));
+            } else if (arg == "--concavity" && hasValue) {
+                generator.setConcavity(std::stof(argv[++i]));
+            } else if (arg == "--density" && hasValue) {
+                generator.setDensity(std::stof(argv[++i]));
+            } else if (arg == "--polygons" && hasValue) {
+                generator.setPolygonShare(std::stof(argv[++i]));
+            } else if (arg == "--seed" && hasValue) {
+                generator.setSeed(std::stoul(argv[++i]));
+            } else if (arg.rfind("--", 0) != 0 && output.empty()) {
+                output = arg;
+            } else {
+                std::cerr << USAGE << std::endl;
+                return 2;
+            }
+        }
+    } catch (const std::logic_error& error) {
+        SPDLOG_ERROR("Invalid argument: {}", error.what());
+        std::cerr << USAGE << std::endl;
+        return 2;
+    }
+
+    if (output.empty()) {
+        std::cerr << USAGE << std::endl;
+        return 2;
+    }
+
+    try {
+        generator.write(output);
+    } catch (const std::runtime_error& error) {
+        SPDLOG_ERROR("{}", error.what());
+        return 1;
+    }
+
+    SPDLOG_INFO("Wrote {}", output);
+    return 0;
+}